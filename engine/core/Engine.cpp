@@ -5,6 +5,15 @@
 #include <tests/CameraController.hpp>
 #include <engine/core/ecs/components/PhysicsComponents.hpp>
 
+le::World::Settings Engine::MakeWorldSettings()
+{
+	le::World::Settings settings;
+	settings.width = 1000.0f; // ширина, высота мира
+	settings.height = 1000.0f;
+	settings.cellSize = 200.0f;
+	return settings;
+}
+
 Engine::Engine()
 {
 	Initialize();
@@ -50,9 +59,12 @@ void Engine::Initialize()
 
 	// ! Инициализация ImGui
 	ImGuiContext::Init(m_Window->GetWindowGLFW());
+
+	// ! Графы задач кадра
+	BuildTaskGraphs();
 	// spatialPartitioning = new SpatialPartitioning(2000, 1000);
 
-	auto &registry = ECS::Get().GetRegistry();
+	auto &registry = m_world.GetRegistry();
 
 	// ! Добавления камеры
 	Object camera = Object::CreateObject(registry);
@@ -111,6 +123,7 @@ void Engine::Run()
 		{
 			utils::Time::Update();
 			InputManager::Get().Update(m_Window->GetWindowGLFW());
+			m_world.GetInput() = InputManager::Get().GetState();
 
 			glfwPollEvents();
 
@@ -128,32 +141,83 @@ void Engine::Run()
 	}
 }
 
+void Engine::BuildTaskGraphs()
+{
+	auto &registry = m_world.GetRegistry();
+	auto &physics = m_world.GetPhysics();
+	auto &scripts = m_world.GetScripts();
+	auto &clock = m_world.GetClock();
+
+	// Renderer создаётся с OpenGL — до того, как к нему обратится рабочий поток
+	Renderer::Get();
+
+	// Скрипты могут трогать что угодно — они Exclusive. Физика пишет только свои компоненты.
+	m_fixedStepGraph.Add("Scripts.FixedUpdate", [&scripts, &registry]
+						 { scripts.FixedUpdate(registry); })
+		.Exclusive();
+	m_fixedStepGraph.Add("Physics", [&physics, &registry, &clock]
+						 { physics.Update(registry, clock.FixedDeltaTime()); })
+		.Write<Transform, le::Rigidbody2D, le::PhysicsSystem>()
+		.Read<le::BoxCollider2D, le::CircleCollider2D, ActiveComponent>();
+	// События шага — одной пачкой, после того как физика закончила менять мир
+	m_fixedStepGraph.Add("Scripts.CollisionEvents", [&scripts, &registry, &physics]
+						 { scripts.DispatchCollisionEvents(registry, physics); })
+		.Exclusive();
+
+	m_updateGraph.Add("Destroy", [&registry, &clock]
+					  { le::DestroySystem::Update(registry, clock.DeltaTime()); })
+		.Exclusive();
+	m_updateGraph.Add("Scripts.Update", [&scripts, &registry]
+					  { scripts.Update(registry); })
+		.Exclusive();
+
+	// Спрайты и отладочные линии собираются параллельно (оба только читают реестр),
+	// в OpenGL уходят из главного потока: сначала линии, затем пачка спрайтов
+	m_drawGraph.Add("Render", [this, &registry, &physics, &clock]
+					{
+		Renderer::Get().BeginBatch();
+		renderSystem.Update(registry, &physics, clock.InterpolationAlpha()); })
+		.Write<Renderer>()
+		.Read<Transform, Sprite, Camera2D, ActiveComponent, le::PhysicsSystem>();
+	m_drawGraph.Add("DebugDraw.Collect", [this, &registry]
+					{ m_debugDrawSystem.Collect(registry); })
+		.Write<le::DebugDrawSystem>()
+		.Read<Transform, le::BoxCollider2D, le::CircleCollider2D, le::Rigidbody2D>();
+	m_drawGraph.Add("DebugDraw.Flush", [this]
+					{ m_debugDrawSystem.Flush(); })
+		.Write<le::DebugDrawSystem>()
+		.Read<Renderer>()
+		.MainThread();
+	m_drawGraph.Add("Renderer.EndBatch", []
+					{ Renderer::Get().EndBatch(); })
+		.Write<Renderer>()
+		.MainThread();
+}
+
 void Engine::Update()
 {
-	// Сначала обновляем физику и коллизии
-	m_physicsSystem.Update(ECS::Get().GetRegistry(), utils::Time::DeltaTime());
-
-	// Затем обновляем позиции и проверяем изменения
-	le::DestroySystem::Update();
-	// Потом скрипты
-	scriptSystem.Update();
-	scriptSystem.FixedUpdate();
+	// Тот же кадр, что World::Step, но шаги раскладываются по графам задач.
+	// Физика и FixedUpdate идут фиксированными шагами: сколько шагов накопилось за кадр
+	// (не больше Clock::MaxFixedSteps). Между шагами RenderSystem интерполирует позиции.
+	auto &clock = m_world.GetClock();
+	clock.Advance(utils::Time::DeltaTime());
+	const int fixedSteps = clock.ConsumeFixedSteps();
+	for (int step = 0; step < fixedSteps; ++step)
+		m_fixedStepGraph.Execute();
+
+	// Затем удаление сущностей и скрипты
+	m_updateGraph.Execute();
 }
 
 void Engine::Draw()
 {
-	Renderer::Get().BeginBatch();
-
 	// ! Выводим в консоль сколько объектов в spatialPartitioning
 	// spatialPartitioning->DrawDebug();
 	// ! Рисуем всю сетку
 	// Renderer::Get().DrawDebugGrid(*spatialPartitioning, glm::vec4(1.0f, 0.0f, 0.0f, 0.5f));
 
-	// ! Обновление всех систем
-	renderSystem.Update();
-	m_debugDrawSystem.Update(ECS::Get().GetRegistry());
-
-	Renderer::Get().EndBatch();
+	// ! Обновление всех систем (BeginBatch / EndBatch — задачи графа)
+	m_drawGraph.Execute();
 
 	// ** ------------
 
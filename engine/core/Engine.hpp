@@ -12,13 +12,13 @@
 // ** ---
 
 #include <engine/core/Systems.hpp>
+#include <engine/core/World.hpp>
+#include <engine/core/utils/TaskGraph.hpp>
 #include <engine/core/ui/ImGuiContext.hpp>
 #include <engine/core/graphics/renderer/GLContext.hpp>
 
 #include <engine/core/ecs/components/PhysicsComponents.hpp>
 
-#include <engine/core/ecs/ECS.hpp>
-
 #include <engine/core/events/EventSystem.hpp>
 
 #include <engine/core/window/GameWindow.hpp>
@@ -45,11 +45,20 @@ private:
 
 	// Системы
 	le::RenderSystem renderSystem;
-	le::ScriptSystem scriptSystem;
-	le::PhysicsSystem m_physicsSystem{1000.0f, 1000.0f, 200.0f}; // ширина, высота мира
 	le::DebugDrawSystem m_debugDrawSystem;
 
+	// Мир окна: реестр, физика, скрипты, время и ввод
+	le::World m_world{MakeWorldSettings()};
+
+	// Графы задач: системы объявляют, что читают и пишут, и независимые идут параллельно
+	utils::TaskGraph m_fixedStepGraph; // один фиксированный шаг: FixedUpdate, физика, события
+	utils::TaskGraph m_updateGraph;	   // остаток кадра после фиксированных шагов
+	utils::TaskGraph m_drawGraph;	   // сбор отрисовки; OpenGL — в главном потоке
+
+	static le::World::Settings MakeWorldSettings();
+
 	void Initialize();
+	void BuildTaskGraphs();
 	void Update();
 	void Draw();
 };
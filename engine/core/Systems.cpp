@@ -1,25 +1,25 @@
 #include <engine/core/Systems.hpp>
 
+#include <cstring>
+
 namespace le
 {
 
 	void DebugDrawSystem::Update(entt::registry &registry)
 	{
-		InitDebugDraw();
+		Collect(registry);
+		Flush();
+	}
 
+	void DebugDrawSystem::Collect(const entt::registry &registry)
+	{
 		// Собираем все линии для отрисовки: {x0, y0, r, g, b, x1, y1, r, g, b}
-		std::vector<float> lineVertices;
+		std::vector<float> &lineVertices = m_lineVertices;
+		lineVertices.clear();
 
-		auto view = registry.view<Transform, BoxCollider2D>();
-		for (auto entity : view)
+		// Цвет: красный для динамических, зелёный для кинематических, синий для статических
+		auto bodyColor = [&](entt::entity entity)
 		{
-			const auto &transform = view.get<Transform>(entity);
-			const auto &collider = view.get<BoxCollider2D>(entity);
-
-			glm::vec2 worldPos = transform.position + collider.offset;
-			glm::vec2 halfSize = collider.size * 0.5f;
-
-			// Цвет: красный для динамических, зелёный для кинематических, синий для статических
 			glm::vec3 color = glm::vec3(1.0f, 0.0f, 0.0f); // по умолчанию — динамический
 
 			if (registry.all_of<Rigidbody2D>(entity))
@@ -32,13 +32,29 @@ namespace le
 					color = glm::vec3(0.0f, 0.0f, 1.0f);
 				}
 			}
+			return color;
+		};
+
+		auto view = registry.view<Transform, BoxCollider2D>();
+		for (auto entity : view)
+		{
+			const auto &transform = view.get<Transform>(entity);
+			const auto &collider = view.get<BoxCollider2D>(entity);
 
-			// 4 угла AABB
+			// Ящик поворачивается вокруг Transform::position вместе со смещением — как в физике
+			const float radians = glm::radians(transform.rotation);
+			const glm::vec2 axisX(std::cos(radians), std::sin(radians));
+			const glm::vec2 axisY(-axisX.y, axisX.x);
+			glm::vec2 worldPos = transform.position + axisX * collider.offset.x + axisY * collider.offset.y;
+			glm::vec2 halfSize = collider.size * 0.5f;
+			const glm::vec3 color = bodyColor(entity);
+
+			// 4 угла ящика
 			std::array<glm::vec2, 4> corners = {
-				worldPos + glm::vec2(-halfSize.x, -halfSize.y),
-				worldPos + glm::vec2(halfSize.x, -halfSize.y),
-				worldPos + glm::vec2(halfSize.x, halfSize.y),
-				worldPos + glm::vec2(-halfSize.x, halfSize.y)};
+				worldPos - axisX * halfSize.x - axisY * halfSize.y,
+				worldPos + axisX * halfSize.x - axisY * halfSize.y,
+				worldPos + axisX * halfSize.x + axisY * halfSize.y,
+				worldPos - axisX * halfSize.x + axisY * halfSize.y};
 
 			// Добавляем 4 линии (замкнутый прямоугольник)
 			auto addLine = [&](const glm::vec2 &a, const glm::vec2 &b)
@@ -53,6 +69,37 @@ namespace le
 			addLine(corners[3], corners[0]);
 		}
 
+		// Круги — ломаной; ящик на той же сущности важнее, круг тогда не рисуем
+		constexpr int k_circleSegments = 24;
+		auto circles = registry.view<Transform, CircleCollider2D>(entt::exclude<BoxCollider2D>);
+		for (auto entity : circles)
+		{
+			const auto &transform = circles.get<Transform>(entity);
+			const auto &collider = circles.get<CircleCollider2D>(entity);
+
+			const float radians = glm::radians(transform.rotation);
+			const glm::vec2 axisX(std::cos(radians), std::sin(radians));
+			const glm::vec2 axisY(-axisX.y, axisX.x);
+			const glm::vec2 center = transform.position + axisX * collider.offset.x + axisY * collider.offset.y;
+			const glm::vec3 color = bodyColor(entity);
+
+			glm::vec2 previous = center + glm::vec2(collider.radius, 0.0f);
+			for (int k = 1; k <= k_circleSegments; ++k)
+			{
+				const float angle = glm::radians(360.0f * static_cast<float>(k) / k_circleSegments);
+				const glm::vec2 point = center + collider.radius * glm::vec2(std::cos(angle), std::sin(angle));
+				lineVertices.insert(lineVertices.end(), {previous.x, previous.y, color.r, color.g, color.b,
+														 point.x, point.y, color.r, color.g, color.b});
+				previous = point;
+			}
+		}
+	}
+
+	void DebugDrawSystem::Flush()
+	{
+		InitDebugDraw();
+
+		const std::vector<float> &lineVertices = m_lineVertices;
 		if (lineVertices.empty())
 			return;
 
@@ -97,7 +144,7 @@ namespace le
 
 	// ! Система рендера объектов
 
-	void CameraSystem::Update(entt::registry &registry, Renderer &renderer)
+	void CameraSystem::Update(const entt::registry &registry, Renderer &renderer)
 	{
 		auto view = registry.view<Transform, Camera2D>();
 		for (auto entity : view)
@@ -126,9 +173,9 @@ namespace le
 		// renderer.SetCamera(defaultCamera, *transform);
 	}
 
-	void RenderSystem::Update()
+	void RenderSystem::Update(const entt::registry &registry, const PhysicsSystem *physics, float alpha)
 	{
-		auto &registry = ECS::Get().GetRegistry();
+		// const: просмотры не создают недостающих хранилищ — реестр только читается
 		auto &renderer = Renderer::Get();
 
 		// Обновляем камеру
@@ -170,6 +217,8 @@ namespace le
 
 			RenderParams params;
 			params.Position = transform.position;
+			if (physics)
+				params.Position += physics->GetInterpolationOffset(entity, alpha);
 			params.Scale = transform.scale;
 			params.Rotation = transform.rotation;
 			params.Origin = transform.origin;
@@ -182,9 +231,8 @@ namespace le
 	}
 
 	// ! Система скриптов
-	void ScriptSystem::Update()
+	void ScriptSystem::Update(entt::registry &registry)
 	{
-		auto &registry = ECS::Get().GetRegistry();
 		auto view = registry.view<ScriptsContainerComponent, ActiveComponent>();
 
 		// for (auto entity : view)
@@ -204,9 +252,8 @@ namespace le
 		} });
 	}
 
-	void ScriptSystem::FixedUpdate()
+	void ScriptSystem::FixedUpdate(entt::registry &registry)
 	{
-		auto &registry = ECS::Get().GetRegistry();
 		auto view = registry.view<ScriptsContainerComponent, ActiveComponent>();
 
 		view.each([&](auto entity, ScriptsContainerComponent &container, ActiveComponent &active)
@@ -225,11 +272,55 @@ namespace le
 		} });
 	}
 
-	void DestroySystem::Update()
+	void ScriptSystem::DispatchCollisionEvents(entt::registry &registry, const PhysicsSystem &physics)
 	{
-		auto &registry = ECS::Get().GetRegistry();
-		const float dt = utils::Time::DeltaTime();
+		using Type = PhysicsSystem::CollisionEvent::Type;
+
+		// Скрипт может удалить сущность или выключить её в обработчике — проверяем перед каждой доставкой
+		auto deliver = [&](entt::entity self, entt::entity other, Type type)
+		{
+			if (!registry.valid(self))
+				return;
+
+			const auto *active = registry.try_get<ActiveComponent>(self);
+			const auto *container = registry.try_get<ScriptsContainerComponent>(self);
+			if (active == nullptr || !active->isActive || container == nullptr)
+				return;
+
+			// Копия списка: обработчик может добавить или удалить скрипты
+			auto scripts = container->scripts;
+			for (auto &script : scripts)
+			{
+				if (!script->IsEnabled())
+					continue;
+
+				switch (type)
+				{
+				case Type::CollisionEnter:
+					script->OnCollisionEnter(other);
+					break;
+				case Type::CollisionExit:
+					script->OnCollisionExit(other);
+					break;
+				case Type::TriggerEnter:
+					script->OnTriggerEnter(other);
+					break;
+				case Type::TriggerExit:
+					script->OnTriggerExit(other);
+					break;
+				}
+			}
+		};
 
+		for (const auto &event : physics.GetEvents())
+		{
+			deliver(event.a, event.b, event.type);
+			deliver(event.b, event.a, event.type);
+		}
+	}
+
+	void DestroySystem::Update(entt::registry &registry, float deltaTime)
+	{
 		// Получаем все сущности с DestroyTimer
 		auto view = registry.view<DestroyTimer>();
 
@@ -237,7 +328,7 @@ namespace le
 		for (auto entity : view)
 		{
 			auto &timer = registry.get<DestroyTimer>(entity);
-			timer.timeLeft -= dt;
+			timer.timeLeft -= deltaTime;
 
 			if (timer.timeLeft <= 0.0f)
 			{
@@ -249,273 +340,1595 @@ namespace le
 	}
 
 	// ! Физика
-	PhysicsSystem::PhysicsSystem(float worldWidth, float worldHeight, float cellSize)
-		: m_worldWidth(worldWidth), m_worldHeight(worldHeight), m_grid(cellSize)
+	PhysicsSystem::PhysicsSystem(float worldWidth, float worldHeight, float cellSize, Broadphase broadphase)
+		: m_worldWidth(worldWidth), m_worldHeight(worldHeight), m_broadphase(broadphase),
+		  m_grid(cellSize, SpatialHashGrid::Mode::Flat), m_hierarchicalGrid(cellSize), m_staticGrid(cellSize, SpatialHashGrid::Mode::Flat),
+		  m_sleepGrid(cellSize, SpatialHashGrid::Mode::Flat),
+		  m_queryGrid(cellSize, SpatialHashGrid::Mode::Flat)
 	{
 	}
 
+	PhysicsSystem::~PhysicsSystem()
+	{
+		m_bodies.Disconnect();
+	}
+
 	void PhysicsSystem::Update(entt::registry &registry, float dt)
 	{
+		m_events.clear();
 		if (dt <= 0.0f)
 			return;
+		++m_stepCount;
+
+		// Хранилище тел подписывается на сигналы реестра один раз
+		m_bodies.Connect(registry);
+		m_bodies.Sync(registry);
 
-		IntegratePositions(registry, dt);
-		ResolveWorldBounds(registry);
-		ResolveCollisions(registry, dt);
+		IntegratePositions(dt);
+		ResolveWorldBounds();
+		ResolveCollisions(dt);
+		SolveContinuous(dt);
+		UpdateSleep(dt);
+
+		m_bodies.WriteBack(registry);
 	}
 
-	void PhysicsSystem::IntegratePositions(entt::registry &registry, float dt)
+	glm::vec2 PhysicsSystem::GetInterpolationOffset(entt::entity entity, float alpha) const
 	{
-		auto view = registry.view<Transform, Rigidbody2D>();
-		for (auto entity : view)
+		uint32_t slot = m_bodies.SlotOf(entity);
+		if (slot == PhysicsBodyStore::k_invalidSlot || !m_bodies.IsSimulated(slot))
+			return glm::vec2(0.0f);
+		// Кинематику двигает скрипт, а не шаг: её previousPositions — позиция прошлого шага
+		if (!m_bodies.IsDynamic(slot))
+			return glm::vec2(0.0f);
+
+		// Скрипт мог сдвинуть Transform после шага — интерполируем только смещение самого шага
+		return (alpha - 1.0f) * (m_bodies.positions[slot] - m_bodies.previousPositions[slot]);
+	}
+
+	namespace
+	{
+		// Образ снимка: заголовок, затем столбцы тел, записи кэшей и отложенные пробуждения.
+		// Каждый раздел выровнен на 8 байт — дельта сравнивает образы словами.
+		struct SnapshotHeader
 		{
-			auto &transform = view.get<Transform>(entity);
-			auto &rb = view.get<Rigidbody2D>(entity);
+			uint32_t magic;
+			uint32_t version;
+			uint64_t step;
+			uint32_t bodyCount;
+			uint32_t contactCount;
+			uint32_t triggerCount;
+			uint32_t wakeCount;
+			uint32_t nextIslandId;
+			uint32_t reserved;
+		};
 
-			if (rb.GetKinematic() || rb.GetStatic())
-				continue;
+		constexpr uint32_t k_snapshotMagic = 0x50534e50; // "PNSP"
+		constexpr uint32_t k_snapshotVersion = 1;
 
-			// Обновляем скорость: v = v + a * dt
-			rb.velocity += rb.acceleration * dt;
+		size_t PaddedSize(size_t bytes) { return (bytes + 7) & ~size_t(7); }
 
-			// Обновляем позицию: p = p + v * dt
-			transform.position += rb.velocity * dt;
+		void WriteSection(std::vector<uint8_t> &image, size_t &at, const void *data, size_t bytes)
+		{
+			if (bytes > 0)
+				std::memcpy(image.data() + at, data, bytes);
+			at += PaddedSize(bytes);
+		}
 
-			// Сбрасываем ускорение (обычно силы прикладываются каждый кадр)
-			rb.acceleration = glm::vec2(0.0f);
+		// Раздел образа: указатель на начало или nullptr, если образ короче
+		const uint8_t *ReadSection(const std::vector<uint8_t> &image, size_t &at, size_t bytes)
+		{
+			if (at + PaddedSize(bytes) > image.size())
+				return nullptr;
+			const uint8_t *section = image.data() + at;
+			at += PaddedSize(bytes);
+			return section;
 		}
 	}
 
-	void PhysicsSystem::ResolveWorldBounds(entt::registry &registry)
+	void PhysicsSystem::SaveSnapshot(PhysicsSnapshot &snapshot, const PhysicsSnapshot *base)
 	{
-		auto view = registry.view<Transform, Rigidbody2D, BoxCollider2D>();
-		for (auto entity : view)
+		const auto &bodies = m_bodies;
+		const size_t bodyCount = bodies.Size();
+		const auto &contacts = m_contactCache.Entries();
+		const auto &triggers = m_triggerCache.Entries();
+		const auto &wakes = bodies.GetPendingWakes();
+
+		const size_t vec2Column = PaddedSize(bodyCount * sizeof(glm::vec2));
+		const size_t size = sizeof(SnapshotHeader) +
+							PaddedSize(bodyCount * sizeof(entt::entity)) +
+							4 * vec2Column +
+							PaddedSize(bodyCount * sizeof(float)) +
+							PaddedSize(bodyCount * sizeof(uint32_t)) +
+							PaddedSize(bodyCount * sizeof(uint8_t)) +
+							PaddedSize(contacts.size() * sizeof(ContactCache::Entry)) +
+							PaddedSize(triggers.size() * sizeof(ContactCache::Entry)) +
+							PaddedSize(wakes.size() * sizeof(uint32_t));
+
+		// Полный снимок пишется сразу в свой буфер, дельта — через промежуточный образ
+		const bool isDelta = base != nullptr && base != &snapshot && !base->IsEmpty() && !base->IsDelta();
+		std::vector<uint8_t> &image = isDelta ? m_snapshotImage : snapshot.m_bytes;
+		image.assign(size, 0); // выравнивание нулевое — одинаковые состояния дают одинаковые байты
+
+		SnapshotHeader header{};
+		header.magic = k_snapshotMagic;
+		header.version = k_snapshotVersion;
+		header.step = m_stepCount;
+		header.bodyCount = static_cast<uint32_t>(bodyCount);
+		header.contactCount = static_cast<uint32_t>(contacts.size());
+		header.triggerCount = static_cast<uint32_t>(triggers.size());
+		header.wakeCount = static_cast<uint32_t>(wakes.size());
+		header.nextIslandId = bodies.GetNextIslandId();
+
+		size_t at = 0;
+		WriteSection(image, at, &header, sizeof(header));
+		WriteSection(image, at, bodies.entities.data(), bodyCount * sizeof(entt::entity));
+		WriteSection(image, at, bodies.positions.data(), bodyCount * sizeof(glm::vec2));
+		WriteSection(image, at, bodies.previousPositions.data(), bodyCount * sizeof(glm::vec2));
+		WriteSection(image, at, bodies.velocities.data(), bodyCount * sizeof(glm::vec2));
+		WriteSection(image, at, bodies.accelerations.data(), bodyCount * sizeof(glm::vec2));
+		WriteSection(image, at, bodies.sleepTimes.data(), bodyCount * sizeof(float));
+		WriteSection(image, at, bodies.islandIds.data(), bodyCount * sizeof(uint32_t));
+		WriteSection(image, at, bodies.flags.data(), bodyCount * sizeof(uint8_t));
+		WriteSection(image, at, contacts.data(), contacts.size() * sizeof(ContactCache::Entry));
+		WriteSection(image, at, triggers.data(), triggers.size() * sizeof(ContactCache::Entry));
+		WriteSection(image, at, wakes.data(), wakes.size() * sizeof(uint32_t));
+
+		if (isDelta)
+		{
+			snapshot.EncodeDelta(image, *base);
+		}
+		else
+		{
+			snapshot.m_isDelta = false;
+			snapshot.m_imageSize = size;
+			snapshot.m_baseStep = 0;
+			snapshot.m_baseSize = 0;
+		}
+		snapshot.m_step = m_stepCount;
+	}
+
+	bool PhysicsSystem::RestoreSnapshot(entt::registry &registry, const PhysicsSnapshot &snapshot,
+										const PhysicsSnapshot *base)
+	{
+		if (snapshot.IsEmpty() && !snapshot.IsDelta())
+			return false;
+
+		// === 1. Образ ===
+		const std::vector<uint8_t> *image = &snapshot.m_bytes;
+		if (snapshot.IsDelta())
+		{
+			if (base == nullptr || !snapshot.DecodeDelta(*base, m_snapshotImage))
+				return false;
+			image = &m_snapshotImage;
+		}
+
+		size_t at = 0;
+		const uint8_t *headerBytes = ReadSection(*image, at, sizeof(SnapshotHeader));
+		if (headerBytes == nullptr)
+			return false;
+
+		SnapshotHeader header;
+		std::memcpy(&header, headerBytes, sizeof(header));
+		if (header.magic != k_snapshotMagic || header.version != k_snapshotVersion)
+			return false;
+
+		const size_t count = header.bodyCount;
+		const uint8_t *entities = ReadSection(*image, at, count * sizeof(entt::entity));
+		const uint8_t *positions = ReadSection(*image, at, count * sizeof(glm::vec2));
+		const uint8_t *previousPositions = ReadSection(*image, at, count * sizeof(glm::vec2));
+		const uint8_t *velocities = ReadSection(*image, at, count * sizeof(glm::vec2));
+		const uint8_t *accelerations = ReadSection(*image, at, count * sizeof(glm::vec2));
+		const uint8_t *sleepTimes = ReadSection(*image, at, count * sizeof(float));
+		const uint8_t *islandIds = ReadSection(*image, at, count * sizeof(uint32_t));
+		const uint8_t *flags = ReadSection(*image, at, count * sizeof(uint8_t));
+		const uint8_t *contacts = ReadSection(*image, at, header.contactCount * sizeof(ContactCache::Entry));
+		const uint8_t *triggers = ReadSection(*image, at, header.triggerCount * sizeof(ContactCache::Entry));
+		const uint8_t *wakes = ReadSection(*image, at, header.wakeCount * sizeof(uint32_t));
+		if (wakes == nullptr)
+			return false;
+
+		// === 2. Тела ===
+		m_bodies.Connect(registry);
+		auto &bodies = m_bodies;
+
+		// Тот же набор тел в тех же слотах (обычный случай для отката) — столбцы копируются
+		// целиком; иначе тела сопоставляются по сущностям
+		const bool sameLayout = count == bodies.Size() &&
+								(count == 0 || std::memcmp(entities, bodies.entities.data(), count * sizeof(entt::entity)) == 0);
+		bool complete = sameLayout;
+
+		auto restoreBody = [&](size_t slot, size_t k)
+		{
+			// Статика сдвинулась — её разбиение нужно пересобрать
+			if (bodies.IsStaticGeometry(slot) &&
+				std::memcmp(&bodies.positions[slot], positions + k * sizeof(glm::vec2), sizeof(glm::vec2)) != 0)
+				m_staticGridBuilt = false;
+
+			std::memcpy(&bodies.positions[slot], positions + k * sizeof(glm::vec2), sizeof(glm::vec2));
+			std::memcpy(&bodies.previousPositions[slot], previousPositions + k * sizeof(glm::vec2), sizeof(glm::vec2));
+			std::memcpy(&bodies.velocities[slot], velocities + k * sizeof(glm::vec2), sizeof(glm::vec2));
+			std::memcpy(&bodies.accelerations[slot], accelerations + k * sizeof(glm::vec2), sizeof(glm::vec2));
+			std::memcpy(&bodies.sleepTimes[slot], sleepTimes + k * sizeof(float), sizeof(float));
+			std::memcpy(&bodies.islandIds[slot], islandIds + k * sizeof(uint32_t), sizeof(uint32_t));
+
+			// Остальные флаги — свойства тела, из снимка берётся только сон
+			bodies.flags[slot] = static_cast<uint8_t>((bodies.flags[slot] & ~PhysicsBodyStore::Sleeping) |
+													  (flags[k] & PhysicsBodyStore::Sleeping));
+			if (bodies.IsSimulated(slot))
+				bodies.MarkChanged(slot);
+		};
+
+		if (sameLayout)
+		{
+			for (size_t k = 0; k < count; ++k)
+				restoreBody(k, k);
+		}
+		else
 		{
-			auto &transform = view.get<Transform>(entity);
-			auto &rb = view.get<Rigidbody2D>(entity);
-			auto &collider = view.get<BoxCollider2D>(entity);
+			size_t found = 0;
+			for (size_t k = 0; k < count; ++k)
+			{
+				entt::entity entity;
+				std::memcpy(&entity, entities + k * sizeof(entt::entity), sizeof(entity));
+				const uint32_t slot = bodies.SlotOf(entity);
+				if (slot == PhysicsBodyStore::k_invalidSlot)
+					continue;
+				restoreBody(slot, k);
+				++found;
+			}
+			complete = found == count && count == bodies.Size();
+		}
 
-			if (rb.GetKinematic() || rb.GetStatic())
+		// === 3. Кэши и сон ===
+		// Разделы выровнены на 8 байт от начала буфера — записи читаются на месте
+		m_contactCache.Restore(reinterpret_cast<const ContactCache::Entry *>(contacts), header.contactCount);
+		m_triggerCache.Restore(reinterpret_cast<const ContactCache::Entry *>(triggers), header.triggerCount);
+		bodies.RestoreIslands(header.nextIslandId, reinterpret_cast<const uint32_t *>(wakes), header.wakeCount);
+
+		m_stepCount = header.step;
+		m_queryGridBuilt = false;
+		// Биты сна восстановлены в обход Sleep / ApplyWakes — версия сна о них не знает
+		m_sleepGridBuilt = false;
+		m_events.clear();
+
+		bodies.WriteBack(registry);
+		return complete;
+	}
+
+	void PhysicsSystem::IntegratePositions(float dt)
+	{
+		auto &bodies = m_bodies;
+
+		// v += a * dt, p += v * dt, ускорение сбрасывается (силы прикладываются каждый кадр).
+		// Только бодрствующие динамические тела с Transform — ядро проверяет это по флагам
+		// векторно, без ветвления на каждое тело. Куски тел независимы, результат от их
+		// числа не зависит.
+		constexpr uint8_t flagMask = PhysicsBodyStore::HasTransform | PhysicsBodyStore::Kinematic |
+									 PhysicsBodyStore::Static | PhysicsBodyStore::Sleeping;
+		constexpr uint8_t flagValue = PhysicsBodyStore::HasTransform;
+
+		utils::ThreadPool::Get().ParallelFor(bodies.Size(), k_minBodiesPerIntegrateChunk, [&](size_t begin, size_t end, size_t /*chunk*/)
+											 { integrateBatch(&bodies.positions[begin], &bodies.velocities[begin], &bodies.accelerations[begin],
+															  &bodies.flags[begin], &bodies.changed[begin], end - begin,
+															  flagMask, flagValue, dt); });
+	}
+
+	void PhysicsSystem::ResolveWorldBounds()
+	{
+		auto &bodies = m_bodies;
+		for (size_t i = 0; i < bodies.Size(); ++i)
+		{
+			if (!bodies.IsSimulated(i) || !bodies.HasCollider(i) || !bodies.IsAwake(i))
 				continue;
 
-			glm::vec2 worldPos = transform.position + collider.offset;
-			glm::vec2 halfSize = collider.size * 0.5f;
+			glm::vec2 &position = bodies.positions[i];
+			glm::vec2 &velocity = bodies.velocities[i];
+			const glm::vec2 &offset = bodies.offsets[i];
+			const glm::vec2 &halfSize = bodies.halfSizes[i];
+			const float restitution = bodies.restitutions[i];
+
+			glm::vec2 worldPos = position + offset;
 
 			// Левая граница
 			if (worldPos.x - halfSize.x < 0.0f)
 			{
-				transform.position.x = halfSize.x - collider.offset.x;
-				rb.velocity.x = glm::abs(rb.velocity.x) * rb.restitution;
+				position.x = halfSize.x - offset.x;
+				velocity.x = glm::abs(velocity.x) * restitution;
 			}
 			// Правая граница
 			if (worldPos.x + halfSize.x > m_worldWidth)
 			{
-				transform.position.x = m_worldWidth - halfSize.x - collider.offset.x;
-				rb.velocity.x = -glm::abs(rb.velocity.x) * rb.restitution;
+				position.x = m_worldWidth - halfSize.x - offset.x;
+				velocity.x = -glm::abs(velocity.x) * restitution;
 			}
 			// Верхняя граница
 			if (worldPos.y - halfSize.y < 0.0f)
 			{
-				transform.position.y = halfSize.y - collider.offset.y;
-				rb.velocity.y = glm::abs(rb.velocity.y) * rb.restitution;
+				position.y = halfSize.y - offset.y;
+				velocity.y = glm::abs(velocity.y) * restitution;
 			}
 			// Нижняя граница
 			if (worldPos.y + halfSize.y > m_worldHeight)
 			{
-				transform.position.y = m_worldHeight - halfSize.y - collider.offset.y;
-				rb.velocity.y = -glm::abs(rb.velocity.y) * rb.restitution;
+				position.y = m_worldHeight - halfSize.y - offset.y;
+				velocity.y = -glm::abs(velocity.y) * restitution;
 			}
 		}
 	}
 
-	glm::vec2 getRotatedAABBSize(const glm::vec2 &size, float rotation)
+	void PhysicsSystem::UpdateStaticPartition()
 	{
-		float hw = size.x * 0.5f;
-		float hh = size.y * 0.5f;
+		const auto &bodies = m_bodies;
+		if (m_staticGridBuilt && bodies.StaticVersion() == m_staticGridVersion)
+			return;
 
-		float cosA = std::abs(std::cos(rotation));
-		float sinA = std::abs(std::sin(rotation));
+		m_staticGrid.ClearGrid();
+		m_staticCategories = 0;
+		for (size_t i = 0; i < bodies.Size(); ++i)
+		{
+			if (!bodies.IsStaticGeometry(i) || !bodies.IsActive(i) || !bodies.HasCollider(i))
+				continue;
 
-		float newW = hw * cosA + hh * sinA;
-		float newH = hw * sinA + hh * cosA;
+			m_staticCategories |= bodies.categories[i];
+			m_staticGrid.InsertGrid(i, bodies.positions[i] + bodies.offsets[i], bodies.halfSizes[i]);
+		}
+		m_staticGrid.Build();
 
-		return glm::vec2(newW * 2.0f, newH * 2.0f); // полный размер
+		m_staticGridBuilt = true;
+		m_staticGridVersion = bodies.StaticVersion();
+		++m_staticRebuildCount;
 	}
 
-	void PhysicsSystem::ResolveCollisions(entt::registry &registry, float dt)
+	void PhysicsSystem::UpdateSleepPartition()
 	{
-		auto view = registry.view<Transform, Rigidbody2D, BoxCollider2D>();
+		const auto &bodies = m_bodies;
+		if (m_sleepGridBuilt && bodies.SleepVersion() == m_sleepGridVersion && bodies.LayoutVersion() == m_sleepGridLayout)
+			return;
 
-		// Сразу собираем данные и считаем количество
-		std::vector<entt::entity> entities;
-		std::vector<glm::vec2> positions;
-		std::vector<glm::vec2> velocities;
-		std::vector<float> rotations;
-		std::vector<float> invMasses;
-		std::vector<glm::vec2> halfSizes;
-		std::vector<float> restitutions; // упругость
-		std::vector<float> frictions;	 // трение
-		std::vector<glm::vec2> offsets;
+		m_sleepGrid.ClearGrid();
+		m_sleepCategories = 0;
+		for (size_t i = 0; i < bodies.Size(); ++i)
+		{
+			if (!bodies.IsSleeping(i) || !bodies.IsActive(i) || !bodies.HasCollider(i))
+				continue;
 
-		for (auto entity : view)
+			m_sleepCategories |= bodies.categories[i];
+			m_sleepGrid.InsertGrid(i, bodies.positions[i] + bodies.offsets[i], bodies.halfSizes[i]);
+		}
+		m_sleepGrid.Build();
+
+		m_sleepGridBuilt = true;
+		m_sleepGridVersion = bodies.SleepVersion();
+		m_sleepGridLayout = bodies.LayoutVersion();
+	}
+
+	void PhysicsSystem::UpdateBroadphase(float dt)
+	{
+		const auto &bodies = m_bodies;
+
+		UpdateStaticPartition();
+		m_staticQueries.clear();
+		m_staticQueryMins.clear();
+		m_staticQueryMaxs.clear();
+
+		// AabbTree сам не ищет пар для спящих — остальным их отдаёт своя сетка
+		const bool sleepPartition = m_broadphase != Broadphase::AabbTree;
+		if (sleepPartition)
+			UpdateSleepPartition();
+		m_sleepQueries.clear();
+		m_sleepQueryMins.clear();
+		m_sleepQueryMaxs.clear();
+
+		switch (m_broadphase)
 		{
-			if (registry.all_of<ActiveComponent>(entity))
+		case Broadphase::SweepAndPrune:
+			m_sweepAndPrune.BeginUpdate(bodies.Size());
+			break;
+		case Broadphase::AabbTree:
+			m_aabbTree.BeginUpdate(bodies.Size());
+			break;
+		case Broadphase::HierarchicalGrid:
+			m_hierarchicalGrid.Clear();
+			break;
+		default:
+			m_grid.ClearGrid();
+			break;
+		}
+
+		// Каждое тело вставляется вместе с путём, пройденным за этот шаг, чтобы быстрые
+		// тела попали в пары с тем, что пролетели насквозь, — такие пары решает CCD.
+		// Статика лежит в своём разбиении: её не вставляем, а бодрствующие тела
+		// опрашивают его сами (только чтение). Спящие — так же, их опрашивают
+		// движущиеся тела, включая сдвинутую кинематику.
+		m_continuous.assign(bodies.Size(), 0);
+		const float continuousMotionSq = 4.0f * k_continuousMotion * k_continuousMotion;
+		for (size_t i = 0; i < bodies.Size(); ++i)
+		{
+			if (!bodies.IsActive(i) || !bodies.HasCollider(i) || bodies.IsStaticGeometry(i))
+				continue;
+			if (sleepPartition && bodies.IsSleeping(i))
+				continue;
+
+			glm::vec2 worldPos = bodies.positions[i] + bodies.offsets[i];
+			glm::vec2 startPos = bodies.previousPositions[i] + bodies.offsets[i];
+			glm::vec2 minCorner = glm::min(worldPos, startPos) - bodies.halfSizes[i];
+			glm::vec2 maxCorner = glm::max(worldPos, startPos) + bodies.halfSizes[i];
+
+			// Пуля — всегда, остальные — если прошли больше k_continuousMotion наименьшего размера
+			if (bodies.IsAwake(i) && !bodies.IsTrigger(i))
 			{
-				const auto &active = registry.get<ActiveComponent>(entity);
-				if (!active.isActive)
-					continue;
+				const glm::vec2 motion = worldPos - startPos;
+				const float minHalfSize = std::min(bodies.halfSizes[i].x, bodies.halfSizes[i].y);
+				m_continuous[i] = bodies.IsBullet(i) ||
+								  glm::dot(motion, motion) > continuousMotionSq * minHalfSize * minHalfSize;
 			}
 
-			auto &t = view.get<Transform>(entity);
-			auto &rb = view.get<Rigidbody2D>(entity);
-			auto &c = view.get<BoxCollider2D>(entity);
+			// Тело, чья маска не видит ни одного слоя статики, статику не опрашивает
+			if (bodies.IsAwake(i) && (bodies.masks[i] & m_staticCategories) != 0)
+			{
+				m_staticQueries.push_back(static_cast<uint32_t>(i));
+				m_staticQueryMins.push_back(minCorner);
+				m_staticQueryMaxs.push_back(maxCorner);
+			}
+
+			if (sleepPartition && bodies.IsMoving(i) && (bodies.masks[i] & m_sleepCategories) != 0)
+			{
+				m_sleepQueries.push_back(static_cast<uint32_t>(i));
+				m_sleepQueryMins.push_back(minCorner);
+				m_sleepQueryMaxs.push_back(maxCorner);
+			}
+
+			switch (m_broadphase)
+			{
+			case Broadphase::SweepAndPrune:
+				m_sweepAndPrune.SetBox(static_cast<uint32_t>(i), minCorner, maxCorner);
+				break;
+			case Broadphase::AabbTree:
+				// Пары ищут только движущиеся тела — спящие и стоящая кинематика лишь лежат в деревьях
+				m_aabbTree.SetBox(static_cast<uint32_t>(i), minCorner, maxCorner,
+								  !bodies.IsDynamic(i), bodies.IsMoving(i));
+				break;
+			case Broadphase::HierarchicalGrid:
+				m_hierarchicalGrid.Insert(static_cast<uint32_t>(i), minCorner, maxCorner);
+				break;
+			default:
+				m_grid.InsertGrid(i, (minCorner + maxCorner) * 0.5f, (maxCorner - minCorner) * 0.5f);
+				break;
+			}
+		}
 
-			entities.push_back(entity);
-			positions.push_back(t.position);
-			velocities.push_back(rb.velocity);
-			rotations.push_back(t.rotation);
-			invMasses.push_back(rb.GetMass());
-			halfSizes.push_back(c.size * 0.5f);
-			restitutions.push_back(rb.restitution);
-			frictions.push_back(rb.friction);
-			offsets.push_back(c.offset);
+		switch (m_broadphase)
+		{
+		case Broadphase::SweepAndPrune:
+			m_sweepAndPrune.EndUpdate();
+			break;
+		case Broadphase::AabbTree:
+			m_aabbTree.EndUpdate();
+			break;
+		case Broadphase::HierarchicalGrid:
+			m_hierarchicalGrid.Build();
+			break;
+		default:
+			m_grid.Build();
+			break;
 		}
 
-		size_t totalEntities = entities.size();
-		if (totalEntities == 0)
-			return;
+		m_dynamicRangeCount = DynamicRangeCount();
+	}
+
+	size_t PhysicsSystem::BroadphaseRangeCount() const
+	{
+		return m_dynamicRangeCount + m_staticQueries.size() + m_sleepQueries.size();
+	}
 
-		// Обновляем grid
-		m_grid.ClearGrid();
-		for (size_t i = 0; i < totalEntities; ++i)
+	size_t PhysicsSystem::DynamicRangeCount() const
+	{
+		switch (m_broadphase)
 		{
-			glm::vec2 worldPos = positions[i] + offsets[i];
-			m_grid.InsertGrid(i, worldPos, halfSizes[i]);
+		case Broadphase::SweepAndPrune:
+			return m_sweepAndPrune.ProxyCount();
+		case Broadphase::AabbTree:
+			return m_aabbTree.QueryCount();
+		case Broadphase::HierarchicalGrid:
+			return m_hierarchicalGrid.ItemCount();
+		default:
+			return m_grid.CellCount();
 		}
+	}
 
-		// === Собираем все контакты один раз ===
-		struct CollisionPair
+	size_t PhysicsSystem::BroadphaseMinRangePerChunk() const
+	{
+		switch (m_broadphase)
+		{
+		case Broadphase::SweepAndPrune:
+			return k_minProxiesPerChunk;
+		case Broadphase::AabbTree:
+			return k_minQueriesPerChunk;
+		case Broadphase::HierarchicalGrid:
+			return k_minItemsPerChunk;
+		default:
+			return k_minCellsPerChunk;
+		}
+	}
+
+	void PhysicsSystem::CollectCandidates(size_t rangeBegin, size_t rangeEnd, CandidateBatch &batch) const
+	{
+		const auto &positions = m_bodies.positions;
+		const auto &halfSizes = m_bodies.halfSizes;
+		const auto &offsets = m_bodies.offsets;
+
+		batch.slotsA.clear();
+		batch.slotsB.clear();
+		batch.shapePairs.clear();
+		for (auto &bucket : batch.buckets)
+			bucket.clear();
+		batch.aabbs.Clear();
+
+		auto collect = [&](size_t i, size_t j)
 		{
-			size_t i, j;
-			Contact contact;
-			SweptResult swept;
-			bool useSwept = false;
-			float restitution, friction;
+			// Пара нужна, если одно из тел двигает солвер или сдвинутая кинематика задела
+			// спящее тело (разбудит его). Сон против сна, статика, кинематика против
+			// кинематики — нет; несовместимые слои — тоже. Всё до narrowphase.
+			auto drives = [&](size_t a, size_t b)
+			{
+				return m_bodies.IsAwake(a) || (m_bodies.IsMovedKinematic(a) && m_bodies.IsSleeping(b));
+			};
+			if (!drives(i, j) && !drives(j, i))
+				return;
+			if (!m_bodies.CanCollide(i, j))
+				return;
+
+			const ShapePair type = ShapePairOf(i, j);
+			batch.buckets[type].push_back(static_cast<uint32_t>(batch.slotsA.size()));
+			batch.slotsA.push_back(static_cast<uint32_t>(i));
+			batch.slotsB.push_back(static_cast<uint32_t>(j));
+			batch.shapePairs.push_back(type);
+			if (type == BoxPair)
+				batch.aabbs.Push({positions[i] + offsets[i], halfSizes[i]}, {positions[j] + offsets[j], halfSizes[j]});
 		};
-		std::vector<CollisionPair> pairs;
 
-		for (size_t i = 0; i < totalEntities; ++i)
+		// Сначала единицы подвижного broadphase, за ними — запросы к разбиениям статики и спящих
+		const size_t dynamicEnd = std::min(rangeEnd, m_dynamicRangeCount);
+		if (rangeBegin < dynamicEnd)
+		{
+			switch (m_broadphase)
+			{
+			case Broadphase::SweepAndPrune:
+				m_sweepAndPrune.ForEachPairInRange(rangeBegin, dynamicEnd, collect);
+				break;
+			case Broadphase::AabbTree:
+				m_aabbTree.ForEachPairInRange(rangeBegin, dynamicEnd, collect);
+				break;
+			case Broadphase::HierarchicalGrid:
+				m_hierarchicalGrid.ForEachPairInRange(rangeBegin, dynamicEnd, collect);
+				break;
+			default:
+				m_grid.ForEachPairInCells(rangeBegin, dynamicEnd, collect);
+				break;
+			}
+		}
+
+		const size_t queryBegin = std::max(rangeBegin, m_dynamicRangeCount) - m_dynamicRangeCount;
+		const size_t queryEnd = std::max(rangeEnd, m_dynamicRangeCount) - m_dynamicRangeCount;
+		for (size_t q = queryBegin; q < queryEnd && q < m_staticQueries.size(); ++q)
+		{
+			const size_t i = m_staticQueries[q];
+			m_staticGrid.ForEachInRange(m_staticQueryMins[q], m_staticQueryMaxs[q], [&](size_t j)
+										{ collect(std::min(i, j), std::max(i, j)); });
+		}
+
+		const size_t sleepOffset = m_dynamicRangeCount + m_staticQueries.size();
+		const size_t sleepBegin = std::max(rangeBegin, sleepOffset) - sleepOffset;
+		const size_t sleepEnd = std::max(rangeEnd, sleepOffset) - sleepOffset;
+		for (size_t q = sleepBegin; q < sleepEnd && q < m_sleepQueries.size(); ++q)
 		{
-			glm::vec2 worldPosA = positions[i] + offsets[i];
-			Aabb aabbA{worldPosA, halfSizes[i]};
+			const size_t i = m_sleepQueries[q];
+			m_sleepGrid.ForEachInRange(m_sleepQueryMins[q], m_sleepQueryMaxs[q], [&](size_t j)
+									   { collect(std::min(i, j), std::max(i, j)); });
+		}
+	}
 
-			m_grid.ForEachNear(worldPosA, [&](size_t j)
-							   {
-			if (i >= j) return;
+	void PhysicsSystem::FindContacts(CandidateBatch &batch, std::vector<CollisionPair> &out) const
+	{
+		const auto &restitutions = m_bodies.restitutions;
+		const auto &frictions = m_bodies.frictions;
+
+		// Каждая корзина фигур проверяется своим однородным циклом (ящики — пакетно, SIMD),
+		// без ветвления по типу на каждую пару. Затем контакты собираются обратно в порядке
+		// кандидатов, как при попарном обходе; пары с быстрыми телами уходят в CCD.
+		using Narrowphase = void (PhysicsSystem::*)(CandidateBatch &) const;
+		static constexpr Narrowphase k_narrowphase[k_shapePairCount] = {
+			&PhysicsSystem::CollideBoxes,
+			&PhysicsSystem::CollideOrientedBoxes,
+			&PhysicsSystem::CollideBoxCircles,
+			&PhysicsSystem::CollideCircles,
+		};
+		for (Narrowphase narrowphase : k_narrowphase)
+			(this->*narrowphase)(batch);
 
-			glm::vec2 worldPosB = positions[j] + offsets[j];
-			Aabb aabbB{worldPosB, halfSizes[j]};
+		size_t cursors[k_shapePairCount] = {};
+		for (size_t k = 0; k < batch.slotsA.size(); ++k)
+		{
+			const size_t i = batch.slotsA[k];
+			const size_t j = batch.slotsB[k];
+			const bool trigger = m_bodies.IsTrigger(i) || m_bodies.IsTrigger(j);
+
+			const uint8_t type = batch.shapePairs[k];
+			size_t &cursor = cursors[type];
+			const Contact *contact = nullptr;
+			if (cursor < batch.hits[type].size() && batch.hits[type][cursor] == k)
+				contact = &batch.contacts[type][cursor++];
+
+			// Быстрое тело, не касавшееся другого в начале шага, идёт через TOI, даже если
+			// сейчас они пересекаются: выталкивание по наименьшей оси протолкнуло бы его
+			// сквозь тонкую стену. Триггеру важно только пересечение сейчас — CCD не нужен.
+			if (!trigger && (m_continuous[i] || m_continuous[j]) && !OverlappedAtStepStart(i, j))
+			{
+				out.push_back({i, j, {}, 0.0f, 0.0f});
+				out.back().isContinuous = true;
+				continue;
+			}
 
+			if (contact == nullptr)
+				continue;
 
+			out.push_back({i, j, *contact,
+				std::min(restitutions[i], restitutions[j]),
+				std::sqrt(frictions[i] * frictions[j])});
+			out.back().isTrigger = trigger;
+		}
+	}
 
-			// Сначала пробуем обычную коллизию
-			Contact contact = collide(aabbA, aabbB);
-			if (contact.intersecting)
+	PhysicsSystem::ShapePair PhysicsSystem::ShapePairOf(size_t i, size_t j) const
+	{
+		// По числу кругов в паре; пара ящиков уточняется поворотом
+		static constexpr ShapePair k_byCircleCount[3] = {BoxPair, BoxCirclePair, CirclePair};
+		const ShapePair type = k_byCircleCount[m_bodies.IsCircle(i) + m_bodies.IsCircle(j)];
+		if (type == BoxPair && (m_bodies.IsOriented(i) || m_bodies.IsOriented(j)))
+			return OrientedBoxPair;
+		return type;
+	}
+
+	Obb PhysicsSystem::OrientedBox(size_t slot) const
+	{
+		return {m_bodies.positions[slot] + m_bodies.offsets[slot], m_bodies.boxHalfSizes[slot], m_bodies.axes[slot]};
+	}
+
+	Circle PhysicsSystem::CircleOf(size_t slot) const
+	{
+		return {m_bodies.positions[slot] + m_bodies.offsets[slot], m_bodies.radii[slot]};
+	}
+
+	void PhysicsSystem::CollideBoxes(CandidateBatch &batch) const
+	{
+		auto &hits = batch.hits[BoxPair];
+		auto &contacts = batch.contacts[BoxPair];
+		hits.clear();
+		contacts.clear();
+		collideBatch(batch.aabbs, hits, contacts);
+
+		// collideBatch возвращает номера внутри корзины — переводим в номера кандидатов
+		const auto &bucket = batch.buckets[BoxPair];
+		for (uint32_t &hit : hits)
+			hit = bucket[hit];
+	}
+
+	void PhysicsSystem::CollideOrientedBoxes(CandidateBatch &batch) const
+	{
+		CollideBucket(batch, OrientedBoxPair, [&](size_t i, size_t j)
+					  { return collide(OrientedBox(i), OrientedBox(j)); });
+	}
+
+	void PhysicsSystem::CollideBoxCircles(CandidateBatch &batch) const
+	{
+		CollideBucket(batch, BoxCirclePair, [&](size_t i, size_t j)
+					  {
+			// Нормаль collide(ящик, круг) — от круга к ящику, а паре нужна от j к i
+			const bool circleFirst = m_bodies.IsCircle(i);
+			Contact contact = collide(OrientedBox(circleFirst ? j : i), CircleOf(circleFirst ? i : j));
+			if (circleFirst)
+				contact.normal = -contact.normal;
+			return contact; });
+	}
+
+	void PhysicsSystem::CollideCircles(CandidateBatch &batch) const
+	{
+		CollideBucket(batch, CirclePair, [&](size_t i, size_t j)
+					  { return collide(CircleOf(i), CircleOf(j)); });
+	}
+
+	bool PhysicsSystem::OverlappedAtStepStart(size_t i, size_t j) const
+	{
+		const auto &bodies = m_bodies;
+		const glm::vec2 delta = glm::abs(bodies.previousPositions[i] + bodies.offsets[i] -
+										 bodies.previousPositions[j] - bodies.offsets[j]);
+		const glm::vec2 extent = bodies.halfSizes[i] + bodies.halfSizes[j];
+		return delta.x < extent.x && delta.y < extent.y;
+	}
+
+	void PhysicsSystem::StoreIfDynamic(const CollisionPair &pair, std::vector<glm::vec2> &values,
+									   const glm::vec2 &valueA, const glm::vec2 &valueB) const
+	{
+		if (m_bodies.invMasses[pair.i] > 0.0f)
+			values[pair.i] = valueA;
+		if (m_bodies.invMasses[pair.j] > 0.0f)
+			values[pair.j] = valueB;
+	}
+
+	uint32_t PhysicsSystem::FindIslandRoot(uint32_t slot)
+	{
+		while (m_islandParents[slot] != slot)
+		{
+			m_islandParents[slot] = m_islandParents[m_islandParents[slot]];
+			slot = m_islandParents[slot];
+		}
+		return slot;
+	}
+
+	void PhysicsSystem::BuildIslands()
+	{
+		const auto &invMasses = m_bodies.invMasses;
+		const size_t bodyCount = m_bodies.Size();
+		const size_t contactCount = m_pairs.size();
+
+		// Острова — связные компоненты по контактам между динамическими телами.
+		// Статические тела солвер не меняет, поэтому острова они не связывают.
+		m_islandParents.resize(bodyCount);
+		for (size_t i = 0; i < bodyCount; ++i)
+			m_islandParents[i] = static_cast<uint32_t>(i);
+
+		for (const auto &pair : m_pairs)
+		{
+			if (invMasses[pair.i] <= 0.0f || invMasses[pair.j] <= 0.0f)
+				continue;
+
+			uint32_t rootA = FindIslandRoot(static_cast<uint32_t>(pair.i));
+			uint32_t rootB = FindIslandRoot(static_cast<uint32_t>(pair.j));
+			if (rootA != rootB)
+				m_islandParents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+		}
+
+		// Номер острова для каждого корня, контакты — сортировкой подсчётом по острову.
+		// Сортировка устойчивая: внутри острова контакты идут в порядке обнаружения.
+		m_islandOfRoot.assign(bodyCount, UINT32_MAX);
+		m_contactIslands.resize(contactCount);
+		uint32_t islandCount = 0;
+		for (size_t k = 0; k < contactCount; ++k)
+		{
+			const auto &pair = m_pairs[k];
+			uint32_t body = static_cast<uint32_t>(invMasses[pair.i] > 0.0f ? pair.i : pair.j);
+			uint32_t root = FindIslandRoot(body);
+			if (m_islandOfRoot[root] == UINT32_MAX)
+				m_islandOfRoot[root] = islandCount++;
+			m_contactIslands[k] = m_islandOfRoot[root];
+		}
+
+		m_islandOffsets.assign(islandCount + 1, 0);
+		for (size_t k = 0; k < contactCount; ++k)
+			++m_islandOffsets[m_contactIslands[k] + 1];
+		for (uint32_t island = 0; island < islandCount; ++island)
+			m_islandOffsets[island + 1] += m_islandOffsets[island];
+
+		m_islandContacts.resize(contactCount);
+		m_islandFill.assign(m_islandOffsets.begin(), m_islandOffsets.end() - 1);
+		for (size_t k = 0; k < contactCount; ++k)
+			m_islandContacts[m_islandFill[m_contactIslands[k]]++] = static_cast<uint32_t>(k);
+
+		// Крупные острова — первыми, чтобы потоки не ждали одного большого в конце
+		m_islandOrder.resize(islandCount);
+		for (uint32_t island = 0; island < islandCount; ++island)
+			m_islandOrder[island] = island;
+		std::stable_sort(m_islandOrder.begin(), m_islandOrder.end(), [&](uint32_t lhs, uint32_t rhs)
+						 { return m_islandOffsets[lhs + 1] - m_islandOffsets[lhs] > m_islandOffsets[rhs + 1] - m_islandOffsets[rhs]; });
+	}
+
+	void PhysicsSystem::SolveIsland(uint32_t island)
+	{
+		auto &positions = m_bodies.positions;
+		auto &velocities = m_bodies.velocities;
+		const auto &invMasses = m_bodies.invMasses;
+
+		const uint32_t *contacts = m_islandContacts.data() + m_islandOffsets[island];
+		const size_t count = m_islandOffsets[island + 1] - m_islandOffsets[island];
+
+		// Статическое тело может касаться нескольких островов. Солвер его не меняет,
+		// но чтобы потоки не писали в одну память — работаем с копиями и пишем назад
+		// только динамические тела.
+		for (size_t q = 0; q < count; ++q)
+		{
+			const size_t k = contacts[q];
+			const auto &pair = m_pairs[k];
+			glm::vec2 velA = velocities[pair.i];
+			glm::vec2 velB = velocities[pair.j];
+			warmStartContact(
+				velA, velB,
+				invMasses[pair.i], invMasses[pair.j],
+				pair.contact.normal,
+				m_normalImpulses[k],
+				m_tangentImpulses[k]);
+			StoreIfDynamic(pair, velocities, velA, velB);
+		}
+
+		// Решение острова зависит только от него самого — ранний выход не ломает
+		// совпадение параллельного солвера с последовательным
+		const auto &settings = m_solverSettings;
+		int velocityIterations = 0;
+		while (velocityIterations < settings.maxVelocityIterations)
+		{
+			float maxImpulseChange = 0.0f;
+			for (size_t q = 0; q < count; ++q)
 			{
-				pairs.push_back({i, j, contact, {}, false,
-					std::min(restitutions[i], restitutions[j]),
-					std::sqrt(frictions[i] * frictions[j])});
-				return;
+				const size_t k = contacts[q];
+				const auto &pair = m_pairs[k];
+				glm::vec2 velA = velocities[pair.i];
+				glm::vec2 velB = velocities[pair.j];
+				const float normalImpulse = m_normalImpulses[k];
+				const float tangentImpulse = m_tangentImpulses[k];
+				solveContactVelocity(
+					velA, velB,
+					invMasses[pair.i], invMasses[pair.j],
+					pair.contact.normal,
+					m_velocityBiases[k],
+					pair.friction,
+					m_normalImpulses[k],
+					m_tangentImpulses[k]);
+				StoreIfDynamic(pair, velocities, velA, velB);
+				maxImpulseChange = std::max({maxImpulseChange, std::abs(m_normalImpulses[k] - normalImpulse),
+											 std::abs(m_tangentImpulses[k] - tangentImpulse)});
 			}
 
-			// Если нет — проверяем swept, если хотя бы один динамический
-			bool aDynamic = invMasses[i] > 0.0f;
-			bool bDynamic = invMasses[j] > 0.0f;
+			++velocityIterations;
+			if (velocityIterations >= settings.minVelocityIterations && maxImpulseChange <= settings.impulseTolerance)
+				break;
+		}
+
+		int positionIterations = 0;
+		while (positionIterations < settings.maxPositionIterations)
+		{
+			float maxPenetration = 0.0f;
+			for (size_t q = 0; q < count; ++q)
+			{
+				const auto &pair = m_pairs[contacts[q]];
+				glm::vec2 posA = positions[pair.i];
+				glm::vec2 posB = positions[pair.j];
+
+				// Текущее проникновение: исходное минус то, на сколько тела уже разошлись
+				// по нормали. Без этого каждая итерация толкала бы по устаревшему значению
+				// и расталкивала тела дальше, чем нужно — контакт пропадал на кадр.
+				float separation = glm::dot(posA - posB, pair.contact.normal);
+				float penetration = pair.contact.penetration - (separation - pair.baseSeparation);
+				maxPenetration = std::max(maxPenetration, penetration);
+
+				resolvePosition(
+					posA, posB,
+					invMasses[pair.i], invMasses[pair.j],
+					pair.contact.normal,
+					penetration,
+					glm::vec2(0) // точка не критична для swept
+				);
+				StoreIfDynamic(pair, positions, posA, posB);
+			}
+
+			++positionIterations;
+			if (positionIterations >= settings.minPositionIterations && maxPenetration <= settings.penetrationTolerance)
+				break;
+		}
+
+		m_islandIterations[island] = {velocityIterations, positionIterations};
+	}
+
+	void PhysicsSystem::SetSolverSettings(const SolverSettings &settings)
+	{
+		m_solverSettings = settings;
+		m_solverSettings.minVelocityIterations = std::max(settings.minVelocityIterations, 0);
+		m_solverSettings.maxVelocityIterations =
+			std::max(settings.maxVelocityIterations, m_solverSettings.minVelocityIterations);
+		m_solverSettings.minPositionIterations = std::max(settings.minPositionIterations, 0);
+		m_solverSettings.maxPositionIterations =
+			std::max(settings.maxPositionIterations, m_solverSettings.minPositionIterations);
+	}
+
+	void PhysicsSystem::UpdateSleep(float dt)
+	{
+		auto &bodies = m_bodies;
+		const size_t bodyCount = bodies.Size();
+
+		if (!m_sleepEnabled)
+		{
+			// Выключили сон — будим всех
+			for (size_t i = 0; i < bodyCount; ++i)
+			{
+				if (bodies.IsSleeping(i))
+					bodies.WakeIsland(bodies.islandIds[i]);
+			}
+			bodies.ApplyWakes();
+			return;
+		}
+
+		// Таймеры покоя
+		const float sleepVelocitySq = k_sleepVelocity * k_sleepVelocity;
+		for (size_t i = 0; i < bodyCount; ++i)
+		{
+			if (!bodies.IsSimulated(i) || !bodies.IsAwake(i))
+				continue;
+
+			const glm::vec2 &velocity = bodies.velocities[i];
+			if (glm::dot(velocity, velocity) > sleepVelocitySq)
+				bodies.sleepTimes[i] = 0.0f;
+			else
+				bodies.sleepTimes[i] += dt;
+		}
+
+		// Острова берём из солвера (BuildIslands). Спящие тела в пары не попадают,
+		// а задетые спящие острова разбужены до решения — все острова бодрствуют.
+
+		// Остров засыпает целиком, когда в покое даже самое "свежее" его тело
+		m_islandSleepTimes.assign(bodyCount, k_timeToSleep);
+		for (size_t i = 0; i < bodyCount; ++i)
+		{
+			if (!bodies.IsSimulated(i) || !bodies.IsAwake(i))
+				continue;
+
+			uint32_t root = FindIslandRoot(static_cast<uint32_t>(i));
+			m_islandSleepTimes[root] = std::min(m_islandSleepTimes[root], bodies.sleepTimes[i]);
+		}
+
+		for (size_t i = 0; i < bodyCount; ++i)
+		{
+			if (!bodies.IsSimulated(i) || !bodies.IsAwake(i))
+				continue;
+
+			uint32_t root = FindIslandRoot(static_cast<uint32_t>(i));
+			if (m_islandSleepTimes[root] < k_timeToSleep)
+				continue;
 
-			if (!aDynamic && !bDynamic) return;
+			// Корень обходится первым (он меньше остальных слотов острова) — он и выдаёт id
+			if (root == i)
+				bodies.islandIds[i] = bodies.NewIslandId();
+			bodies.Sleep(i, bodies.islandIds[root]);
+		}
+	}
 
-			// Для swept нужна скорость ОДНОГО тела относительно другого
-			glm::vec2 relVel = velocities[i] - velocities[j];
-			float speed = glm::length(relVel);
-			float minSize = std::min({
-				halfSizes[i].x * 2, halfSizes[i].y * 2,
-				halfSizes[j].x * 2, halfSizes[j].y * 2
-			});
+	bool PhysicsSystem::IsRetainedBySleep(uint64_t key) const
+	{
+		uint32_t a = m_bodies.SlotOf(ContactCache::KeyFirst(key));
+		uint32_t b = m_bodies.SlotOf(ContactCache::KeySecond(key));
+		if (a == PhysicsBodyStore::k_invalidSlot || b == PhysicsBodyStore::k_invalidSlot)
+			return false;
+		// Та же граница, что у CollectCandidates: пару со сдвинутой кинематикой проверили
+		return (m_bodies.IsSleeping(a) || m_bodies.IsSleeping(b)) &&
+			   !m_bodies.IsMoving(a) && !m_bodies.IsMoving(b);
+	}
+
+	void PhysicsSystem::ExtractContinuousPairs()
+	{
+		auto &pairs = m_pairs;
 
-			// Эвристика: если за кадр проходит > половины минимального размера — используем swept
-			if (speed * dt > minSize * 0.5f)
+		m_continuousTargets.clear();
+		size_t kept = 0;
+		for (size_t k = 0; k < pairs.size(); ++k)
+		{
+			const auto &pair = pairs[k];
+			if (pair.isContinuous)
 			{
-				SweptResult swept;
-				if (aDynamic && !bDynamic)
+				// Оба тела быстрые — пара нужна каждому
+				if (m_continuous[pair.i])
+					m_continuousTargets.emplace_back(static_cast<uint32_t>(pair.i), static_cast<uint32_t>(pair.j));
+				if (m_continuous[pair.j])
+					m_continuousTargets.emplace_back(static_cast<uint32_t>(pair.j), static_cast<uint32_t>(pair.i));
+				continue;
+			}
+			if (kept != k)
+				pairs[kept] = pairs[k];
+			++kept;
+		}
+		pairs.resize(kept);
+
+		// Тела обходятся по слотам, их цели — тоже: результат не зависит от числа потоков
+		std::sort(m_continuousTargets.begin(), m_continuousTargets.end());
+	}
+
+	void PhysicsSystem::SolveContinuous(float dt)
+	{
+		auto &bodies = m_bodies;
+		const auto &targets = m_continuousTargets;
+		m_continuousHitCount = 0;
+
+		// Удары CCD не попадают в кэш контактов: события пара даёт, когда тела коснутся
+		// в дискретной проверке. Тела обходятся по очереди — позже обойдённое видит
+		// уже исправленный путь предыдущего.
+		for (size_t begin = 0; begin < targets.size();)
+		{
+			const uint32_t i = targets[begin].first;
+			size_t end = begin;
+			while (end < targets.size() && targets[end].first == i)
+				++end;
+
+			// Путь шага — от позиции в начале шага до той, что оставил солвер.
+			// time — пройденная доля шага, motion — смещение до его конца.
+			const glm::vec2 halfSize = bodies.halfSizes[i];
+			glm::vec2 center = bodies.previousPositions[i] + bodies.offsets[i];
+			glm::vec2 motion = bodies.positions[i] - bodies.previousPositions[i];
+			float time = 0.0f;
+
+			for (int subStep = 0; subStep < k_maxToiSubSteps; ++subStep)
+			{
+				// Ближайший удар на остатке пути. Другое тело идёт по прямой от начала шага
+				// к концу, поэтому сравниваем относительное смещение — для AABB без
+				// поворота это точное время удара.
+				uint32_t target = PhysicsBodyStore::k_invalidSlot;
+				float toi = 1.0f;
+				glm::vec2 normal(0.0f);
+				glm::vec2 relativeMotion(0.0f);
+				for (size_t q = begin; q < end; ++q)
 				{
-					// A движется, B статический
-					swept = sweptAABB(aabbA, velocities[i], aabbB, dt);
+					const uint32_t j = targets[q].second;
+					const glm::vec2 startB = bodies.previousPositions[j] + bodies.offsets[j];
+					const glm::vec2 pathB = bodies.positions[j] + bodies.offsets[j] - startB;
+					const glm::vec2 relative = motion - pathB * (1.0f - time);
+
+					SweptResult swept = sweptAABB({center, halfSize}, relative,
+												  {startB + pathB * time, bodies.halfSizes[j]}, 1.0f);
+					if (swept.hit && (target == PhysicsBodyStore::k_invalidSlot || swept.time < toi))
+					{
+						target = j;
+						toi = swept.time;
+						normal = swept.normal;
+						relativeMotion = relative;
+					}
 				}
-				else if (bDynamic && !aDynamic)
+
+				if (target == PhysicsBodyStore::k_invalidSlot)
 				{
-					// B движется, A статический
-					swept = sweptAABB(aabbB, velocities[j], aabbA, dt);
-					if (swept.hit) swept.normal = -swept.normal; // инвертируем нормаль
+					center += motion;
+					break;
 				}
-				else
+
+				// Встаём чуть раньше удара — следующий подшаг не должен начаться с пересечения
+				const float distance = glm::length(relativeMotion);
+				const float stop = distance > 0.0f ? std::max(0.0f, toi - k_toiSlop / distance) : 0.0f;
+				center += motion * stop;
+				time += (1.0f - time) * toi;
+				++m_continuousHitCount;
+
+				// Импульс по нормали с упругостью пары, касательная скорость не меняется
+				glm::vec2 &velocityA = bodies.velocities[i];
+				glm::vec2 &velocityB = bodies.velocities[target];
+				const float invMassA = bodies.invMasses[i];
+				const float invMassB = bodies.invMasses[target];
+				const float approach = glm::dot(velocityA - velocityB, normal);
+				if (approach < 0.0f && invMassA + invMassB > 0.0f)
 				{
-					// Оба динамические — упрощённо: считаем B неподвижным, A движется с relVel
-					swept = sweptAABB(aabbA, relVel, aabbB, dt);
+					const float restitution = std::min(bodies.restitutions[i], bodies.restitutions[target]);
+					const float impulse = -(1.0f + restitution) * approach / (invMassA + invMassB);
+					velocityA += normal * (impulse * invMassA);
+					velocityB -= normal * (impulse * invMassB);
 				}
 
-				if (swept.hit)
+				if (invMassB > 0.0f)
 				{
-					// Создаём Contact из swept
-					Contact sweptContact;
-					sweptContact.intersecting = true;
-					sweptContact.normal = swept.normal;
-					// Проникновение — приблизительно
-					sweptContact.penetration = 0.01f; // или вычисли точнее
-
-					pairs.push_back({i, j, sweptContact, swept, true,
-						std::min(restitutions[i], restitutions[j]),
-						std::sqrt(frictions[i] * frictions[j])});
+					if (bodies.IsSleeping(target))
+						bodies.WakeIsland(bodies.islandIds[target]);
+					bodies.MarkChanged(target);
 				}
-			} });
+
+				// Остаток шага тело идёт с новой скоростью. Кончились подшаги — стоит перед ударом.
+				motion = velocityA * dt * (1.0f - time);
+			}
+
+			bodies.positions[i] = center - bodies.offsets[i];
+			bodies.MarkChanged(i);
+			begin = end;
 		}
 
-		// === Velocity & Position решатели (без изменений) ===
-		const int velocityIterations = 12;
-		for (int iter = 0; iter < velocityIterations; ++iter)
+		bodies.ApplyWakes();
+	}
+
+	void PhysicsSystem::ExtractTriggerPairs()
+	{
+		auto &pairs = m_pairs;
+		const auto &entities = m_bodies.entities;
+
+		// Пары с триггером вынимаем, остальные сдвигаем, сохраняя порядок
+		m_triggerKeys.clear();
+		size_t kept = 0;
+		for (size_t k = 0; k < pairs.size(); ++k)
 		{
-			for (const auto &pair : pairs)
+			if (pairs[k].isTrigger)
 			{
-				resolveVelocity(
-					velocities[pair.i], velocities[pair.j],
-					invMasses[pair.i], invMasses[pair.j],
-					pair.contact.normal,
-					pair.contact.penetration,
-					pair.restitution,
-					pair.friction,
-					dt);
+				m_triggerKeys.push_back(ContactCache::MakeKey(entities[pairs[k].i], entities[pairs[k].j]));
+				continue;
 			}
+			if (kept != k)
+				pairs[kept] = pairs[k];
+			++kept;
 		}
+		pairs.resize(kept);
+
+		// Тот же отсортированный diff с прошлым шагом, что и для контактов
+		const size_t count = m_triggerKeys.size();
+		m_triggerNormals.assign(count, glm::vec2(0.0f, 1.0f));
+		m_triggerImpulses.resize(count * 2);
+		m_triggerCache.BeginStep(m_triggerKeys.data(), m_triggerNormals.data(), count,
+								 m_triggerImpulses.data(), m_triggerImpulses.data() + count,
+								 [&](uint64_t key)
+								 { return IsRetainedBySleep(key); });
+		m_triggerCache.EndStep(m_triggerImpulses.data(), m_triggerImpulses.data() + count);
+	}
 
-		const int positionIterations = 4;
-		for (int iter = 0; iter < positionIterations; ++iter)
+	void PhysicsSystem::CollectEvents()
+	{
+		using Type = CollisionEvent::Type;
+
+		auto push = [&](const std::vector<uint64_t> &keys, Type type)
+		{
+			for (uint64_t key : keys)
+				m_events.push_back({type, ContactCache::KeyFirst(key), ContactCache::KeySecond(key)});
+		};
+
+		// Выходы раньше входов: скрипт, переехавший из одной пары в другую, видит их по порядку
+		push(m_contactCache.Ended(), Type::CollisionExit);
+		push(m_triggerCache.Ended(), Type::TriggerExit);
+		push(m_contactCache.Began(), Type::CollisionEnter);
+		push(m_triggerCache.Began(), Type::TriggerEnter);
+	}
+
+	void PhysicsSystem::ResolveCollisions(float dt)
+	{
+		// Данные берём прямо из SoA-хранилища — без пересборки массивов каждый кадр
+		auto &bodies = m_bodies;
+		auto &positions = bodies.positions;
+		auto &velocities = bodies.velocities;
+		const auto &invMasses = bodies.invMasses;
+
+		// Даже без тел идём дальше — кэш контактов должен увидеть, что все контакты закончились
+		UpdateBroadphase(dt);
+
+		// === Собираем все контакты один раз ===
+		auto &pairs = m_pairs;
+		pairs.clear();
+
+		// Каждая пара приходит из broadphase ровно один раз — narrowphase не повторяется
+		const size_t rangeCount = BroadphaseRangeCount();
+		const size_t minRangePerChunk = BroadphaseMinRangePerChunk();
+		auto &pool = utils::ThreadPool::Get();
+
+		if (m_parallelBroadphase && bodies.Size() >= k_parallelMinBodies && pool.WorkerCount() > 1)
+		{
+			// Каждый кусок ячеек (прокси, запросов) пишет в свой буфер; буферы склеиваются по порядку кусков,
+			// поэтому список пар совпадает с последовательным обходом при любом числе потоков
+			size_t chunkCount = pool.ChunkCount(rangeCount, minRangePerChunk);
+			if (m_pairBuffers.size() < chunkCount)
+				m_pairBuffers.resize(chunkCount);
+			if (m_candidateBuffers.size() < chunkCount)
+				m_candidateBuffers.resize(chunkCount);
+
+			pool.ParallelFor(rangeCount, minRangePerChunk, [&](size_t begin, size_t end, size_t chunk)
+							 {
+				auto &buffer = m_pairBuffers[chunk];
+				buffer.clear();
+				CollectCandidates(begin, end, m_candidateBuffers[chunk]);
+				FindContacts(m_candidateBuffers[chunk], buffer); });
+
+			for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+				pairs.insert(pairs.end(), m_pairBuffers[chunk].begin(), m_pairBuffers[chunk].end());
+		}
+		else
+		{
+			if (m_candidateBuffers.empty())
+				m_candidateBuffers.resize(1);
+
+			CollectCandidates(0, rangeCount, m_candidateBuffers[0]);
+			FindContacts(m_candidateBuffers[0], pairs);
+		}
+
+		// Пары быстрых тел решает CCD после солвера, триггеры идут только в события
+		ExtractContinuousPairs();
+		ExtractTriggerPairs();
+
+		// === Warm starting: импульсы прошлого кадра из кэша контактов ===
+		const size_t contactCount = pairs.size();
+		m_contactKeys.resize(contactCount);
+		m_contactNormals.resize(contactCount);
+		m_normalImpulses.resize(contactCount);
+		m_tangentImpulses.resize(contactCount);
+		m_velocityBiases.resize(contactCount);
+
+		for (size_t k = 0; k < contactCount; ++k)
+		{
+			auto &pair = pairs[k];
+			pair.baseSeparation = glm::dot(positions[pair.i] - positions[pair.j], pair.contact.normal);
+			m_contactKeys[k] = ContactCache::MakeKey(bodies.entities[pair.i], bodies.entities[pair.j]);
+			m_contactNormals[k] = pair.contact.normal;
+		}
+
+		// Контакты спящих тел не проверялись, но не закончились — импульсы сохраняются
+		// до пробуждения, и остров не проседает, начиная с нуля
+		m_contactCache.BeginStep(m_contactKeys.data(), m_contactNormals.data(), contactCount,
+								 m_normalImpulses.data(), m_tangentImpulses.data(),
+								 [&](uint64_t key)
+								 { return IsRetainedBySleep(key); });
+
+		// Скорость отскока считаем до warm start — по скорости сближения этого кадра.
+		// Отдельным проходом: warm start одного контакта меняет скорости соседних.
+		for (size_t k = 0; k < contactCount; ++k)
+		{
+			const auto &pair = pairs[k];
+			m_velocityBiases[k] = contactVelocityBias(
+				velocities[pair.i], velocities[pair.j], pair.contact.normal, pair.restitution);
+		}
+
+		// Движущееся тело (бодрствующее или сдвинутая кинематика) будит спящий остров, которого коснулось
+		if (m_sleepEnabled)
 		{
 			for (const auto &pair : pairs)
 			{
-				resolvePosition(
-					positions[pair.i], positions[pair.j],
-					invMasses[pair.i], invMasses[pair.j],
-					pair.contact.normal,
-					pair.contact.penetration,
-					glm::vec2(0) // точка не критична для swept
-				);
+				if (bodies.IsSleeping(pair.i) && bodies.IsMoving(pair.j))
+					bodies.WakeIsland(bodies.islandIds[pair.i]);
+				else if (bodies.IsSleeping(pair.j) && bodies.IsMoving(pair.i))
+					bodies.WakeIsland(bodies.islandIds[pair.j]);
+			}
+			bodies.ApplyWakes();
+		}
+
+		// === Velocity & Position решатели ===
+		// Острова не имеют общих динамических тел, поэтому решаются независимо — в пуле
+		// потоков. Внутри острова контакты идут в порядке обнаружения, так что результат
+		// бит в бит совпадает с последовательным обходом всех контактов.
+		BuildIslands();
+
+		const size_t islandCount = m_islandOrder.size();
+		m_islandIterations.resize(islandCount);
+		if (m_parallelSolver && contactCount >= k_parallelMinContacts && islandCount > 1)
+		{
+			utils::ThreadPool::Get().ParallelFor(islandCount, 1, [&](size_t begin, size_t end, size_t /*chunk*/)
+												 {
+				for (size_t q = begin; q < end; ++q)
+					SolveIsland(m_islandOrder[q]); });
+		}
+		else
+		{
+			for (size_t q = 0; q < islandCount; ++q)
+				SolveIsland(m_islandOrder[q]);
+		}
+
+		m_solverStats = {};
+		m_solverStats.islands = islandCount;
+		m_solverStats.contacts = contactCount;
+		for (const auto &[velocityIterations, positionIterations] : m_islandIterations)
+		{
+			m_solverStats.velocityIterations += velocityIterations;
+			m_solverStats.positionIterations += positionIterations;
+			m_solverStats.maxVelocityIterations = std::max(m_solverStats.maxVelocityIterations, velocityIterations);
+			m_solverStats.maxPositionIterations = std::max(m_solverStats.maxPositionIterations, positionIterations);
+		}
+
+		// Сохраняем накопленные импульсы для следующего кадра
+		m_contactCache.EndStep(m_normalImpulses.data(), m_tangentImpulses.data());
+		CollectEvents();
+
+		// В компоненты попадут только тела, которых коснулся солвер
+		for (const auto &pair : pairs)
+		{
+			if (invMasses[pair.i] > 0.0f)
+				bodies.MarkChanged(pair.i);
+			if (invMasses[pair.j] > 0.0f)
+				bodies.MarkChanged(pair.j);
+		}
+	}
+
+	// ! Пространственные запросы
+	namespace
+	{
+		// Отрезок from + delta * t против круга. Луч, начавшийся внутри, не попадает.
+		bool RayVsCircle(const glm::vec2 &from, const glm::vec2 &delta, const glm::vec2 &center, float radius,
+						 float maxFraction, float &fraction, glm::vec2 &normal)
+		{
+			const glm::vec2 start = from - center;
+			const float a = glm::dot(delta, delta);
+			const float b = glm::dot(start, delta);
+			const float c = glm::dot(start, start) - radius * radius;
+			if (c < 0.0f || a == 0.0f || b >= 0.0f)
+				return false;
+
+			const float discriminant = b * b - a * c;
+			if (discriminant < 0.0f)
+				return false;
+
+			const float t = (-b - std::sqrt(discriminant)) / a;
+			if (t < 0.0f || t > maxFraction)
+				return false;
+
+			fraction = t;
+			normal = (start + delta * t) / radius;
+			return true;
+		}
+
+		// Отрезок from + delta * t против AABB (slab-тест). Луч, начавшийся внутри, не попадает.
+		bool RayVsBox(const glm::vec2 &from, const glm::vec2 &delta, const glm::vec2 &minCorner,
+					  const glm::vec2 &maxCorner, float maxFraction, float &fraction, glm::vec2 &normal)
+		{
+			float tMin = -std::numeric_limits<float>::infinity();
+			float tMax = std::numeric_limits<float>::infinity();
+			glm::vec2 hitNormal(0.0f);
+
+			for (int axis = 0; axis < 2; ++axis)
+			{
+				if (delta[axis] == 0.0f)
+				{
+					if (from[axis] < minCorner[axis] || from[axis] > maxCorner[axis])
+						return false;
+					continue;
+				}
+
+				float inv = 1.0f / delta[axis];
+				float t1 = (minCorner[axis] - from[axis]) * inv;
+				float t2 = (maxCorner[axis] - from[axis]) * inv;
+				float side = -1.0f; // входим через грань min
+				if (t1 > t2)
+				{
+					std::swap(t1, t2);
+					side = 1.0f;
+				}
+
+				if (t1 > tMin)
+				{
+					tMin = t1;
+					hitNormal = glm::vec2(0.0f);
+					hitNormal[axis] = side;
+				}
+				tMax = std::min(tMax, t2);
+				if (tMin > tMax)
+					return false;
 			}
+
+			if (tMin < 0.0f || tMin > maxFraction)
+				return false;
+
+			fraction = tMin;
+			normal = hitNormal;
+			return true;
 		}
 
-		// Записываем обратно
-		for (size_t i = 0; i < totalEntities; ++i)
+		// Квадрат расстояния от точки до AABB (0 внутри)
+		float DistanceSqToBox(const glm::vec2 &point, const glm::vec2 &minCorner, const glm::vec2 &maxCorner)
+		{
+			glm::vec2 d = point - glm::clamp(point, minCorner, maxCorner);
+			return glm::dot(d, d);
+		}
+	}
+
+	void PhysicsSystem::PrepareQueries()
+	{
+		// Статика — та же сетка, что у broadphase; пересобирается, только если статика менялась
+		UpdateStaticPartition();
+
+		const auto &bodies = m_bodies;
+		if (m_queryGridBuilt && m_queryGridStep == m_stepCount && m_queryGridLayout == bodies.LayoutVersion())
+			return;
+
+		m_queryGrid.ClearGrid();
+		for (size_t i = 0; i < bodies.Size(); ++i)
 		{
-			registry.get<Transform>(entities[i]).position = positions[i];
-			registry.get<Rigidbody2D>(entities[i]).velocity = velocities[i];
+			if (!bodies.IsActive(i) || !bodies.HasCollider(i) || bodies.IsStaticGeometry(i))
+				continue;
+
+			m_queryGrid.InsertGrid(i, bodies.positions[i] + bodies.offsets[i], bodies.halfSizes[i]);
 		}
+		m_queryGrid.Build();
+
+		m_queryGridBuilt = true;
+		m_queryGridStep = m_stepCount;
+		m_queryGridLayout = bodies.LayoutVersion();
+	}
+
+	bool PhysicsSystem::PassesFilter(size_t slot, const QueryFilter &filter) const
+	{
+		if ((m_bodies.categories[slot] & filter.maskBits) == 0)
+			return false;
+		if (!filter.includeTriggers && m_bodies.IsTrigger(slot))
+			return false;
+		return m_bodies.entities[slot] != filter.ignore;
+	}
+
+	void PhysicsSystem::RaycastPrepared(const Ray &ray, RaycastHit &hit, const QueryFilter &filter, bool anyHit) const
+	{
+		const auto &bodies = m_bodies;
+		const glm::vec2 delta = ray.to - ray.from;
+
+		hit = RaycastHit{};
+		size_t hitSlot = SIZE_MAX;
+
+		// Возвращает новое ограничение доли: дальше ближайшего попадания сетке идти незачем
+		auto visit = [&](size_t slot) -> float
+		{
+			if (!PassesFilter(slot, filter))
+				return hit.fraction;
+
+			const glm::vec2 center = bodies.positions[slot] + bodies.offsets[slot];
+			float fraction;
+			glm::vec2 normal;
+			if (bodies.IsCircle(slot))
+			{
+				if (!RayVsCircle(ray.from, delta, center, bodies.radii[slot], hit.fraction, fraction, normal))
+					return hit.fraction;
+			}
+			else if (bodies.IsOriented(slot))
+			{
+				// Повёрнутый ящик: луч переводим в его оси, нормаль — обратно в мир
+				const glm::vec2 axis = bodies.axes[slot];
+				auto toLocal = [&](const glm::vec2 &v) { return glm::vec2(axis.x * v.x + axis.y * v.y, axis.x * v.y - axis.y * v.x); };
+				const glm::vec2 &halfSize = bodies.boxHalfSizes[slot];
+				if (!RayVsBox(toLocal(ray.from - center), toLocal(delta), -halfSize, halfSize, hit.fraction, fraction, normal))
+					return hit.fraction;
+				normal = {axis.x * normal.x - axis.y * normal.y, axis.y * normal.x + axis.x * normal.y};
+			}
+			else
+			{
+				const glm::vec2 &halfSize = bodies.halfSizes[slot];
+				if (!RayVsBox(ray.from, delta, center - halfSize, center + halfSize, hit.fraction, fraction, normal))
+					return hit.fraction;
+			}
+
+			// При равной доле побеждает меньший слот — результат не зависит от порядка обхода
+			if (fraction == hit.fraction && hitSlot < slot)
+				return hit.fraction;
+
+			hitSlot = slot;
+			hit.fraction = fraction;
+			hit.normal = normal;
+			return anyHit ? 0.0f : fraction;
+		};
+
+		m_staticGrid.ForEachOnRay(ray.from, delta, 1.0f, visit);
+		if (!(anyHit && hitSlot != SIZE_MAX))
+			m_queryGrid.ForEachOnRay(ray.from, delta, hit.fraction, visit);
+
+		if (hitSlot == SIZE_MAX)
+		{
+			hit.fraction = 1.0f;
+			return;
+		}
+
+		hit.entity = bodies.entities[hitSlot];
+		hit.point = ray.from + delta * hit.fraction;
+	}
+
+	bool PhysicsSystem::Raycast(const glm::vec2 &from, const glm::vec2 &to, RaycastHit &hit, const QueryFilter &filter)
+	{
+		PrepareQueries();
+		RaycastPrepared({from, to}, hit, filter, false);
+		return hit.entity != entt::null;
+	}
+
+	bool PhysicsSystem::LineOfSight(const glm::vec2 &from, const glm::vec2 &to, const QueryFilter &filter)
+	{
+		PrepareQueries();
+		RaycastHit hit;
+		RaycastPrepared({from, to}, hit, filter, true);
+		return hit.entity == entt::null;
+	}
+
+	void PhysicsSystem::RaycastBatch(const Ray *rays, size_t count, RaycastHit *hits, const QueryFilter &filter,
+									 bool anyHit)
+	{
+		PrepareQueries();
+
+		// Сетки дальше только читаются — лучи независимы
+		utils::ThreadPool::Get().ParallelFor(count, k_minRaysPerChunk, [&](size_t begin, size_t end, size_t /*chunk*/)
+											 {
+			for (size_t q = begin; q < end; ++q)
+				RaycastPrepared(rays[q], hits[q], filter, anyHit); });
+	}
+
+	void PhysicsSystem::OverlapBox(const glm::vec2 &center, const glm::vec2 &halfSize, std::vector<entt::entity> &out,
+								   const QueryFilter &filter)
+	{
+		PrepareQueries();
+
+		// ForEachInRange уже проверил пересечение AABB
+		ForEachQueryBodyInRange(center - halfSize, center + halfSize, [&](size_t slot)
+								{
+			if (PassesFilter(slot, filter))
+				out.push_back(m_bodies.entities[slot]); });
+	}
+
+	void PhysicsSystem::OverlapCircle(const glm::vec2 &center, float radius, std::vector<entt::entity> &out,
+									  const QueryFilter &filter)
+	{
+		PrepareQueries();
+
+		const float radiusSq = radius * radius;
+		ForEachQueryBodyInRange(center - glm::vec2(radius), center + glm::vec2(radius), [&](size_t slot)
+								{
+			if (!PassesFilter(slot, filter))
+				return;
+
+			const glm::vec2 bodyCenter = m_bodies.positions[slot] + m_bodies.offsets[slot];
+			const glm::vec2 &halfSize = m_bodies.halfSizes[slot];
+			if (DistanceSqToBox(center, bodyCenter - halfSize, bodyCenter + halfSize) <= radiusSq)
+				out.push_back(m_bodies.entities[slot]); });
+	}
+
+	void PhysicsSystem::QueryPoint(const glm::vec2 &point, std::vector<entt::entity> &out, const QueryFilter &filter)
+	{
+		OverlapBox(point, glm::vec2(0.0f), out, filter);
+	}
+
+	void PhysicsSystem::FindNearest(const glm::vec2 &point, size_t k, std::vector<entt::entity> &out, float maxDistance,
+									const QueryFilter &filter)
+	{
+		out.clear();
+		if (k == 0 || maxDistance < 0.0f)
+			return;
+
+		PrepareQueries();
+
+		// Все тела лежат внутри сеток — дальше их границ радиус не растёт
+		bool hasBodies = false;
+		glm::vec2 boundsMin(std::numeric_limits<float>::max());
+		glm::vec2 boundsMax(std::numeric_limits<float>::lowest());
+		for (const SpatialHashGrid *grid : {&m_staticGrid, &m_queryGrid})
+		{
+			if (grid->IsEmpty())
+				continue;
+			hasBodies = true;
+			boundsMin = glm::min(boundsMin, grid->FlatMin());
+			boundsMax = glm::max(boundsMax, grid->FlatMax());
+		}
+		if (!hasBodies)
+			return;
+
+		const glm::vec2 farthest = glm::max(glm::abs(point - boundsMin), glm::abs(point - boundsMax));
+		const float limit = std::min(maxDistance, glm::length(farthest));
+
+		// Радиус удваивается, пока в нём не наберётся k тел: все тела ближе radius
+		// пересекают квадрат [point - radius, point + radius], так что ответ точный
+		auto &heap = m_nearestHeap;
+		auto farther = [&](const std::pair<float, uint32_t> &lhs, const std::pair<float, uint32_t> &rhs)
+		{
+			if (lhs.first != rhs.first)
+				return lhs.first < rhs.first;
+			return entt::to_integral(m_bodies.entities[lhs.second]) < entt::to_integral(m_bodies.entities[rhs.second]);
+		};
+
+		float radius = std::min(m_staticGrid.GetCellSize(), limit);
+		while (true)
+		{
+			heap.clear();
+			const float radiusSq = radius * radius;
+			ForEachQueryBodyInRange(point - glm::vec2(radius), point + glm::vec2(radius), [&](size_t slot)
+									{
+				if (!PassesFilter(slot, filter))
+					return;
+
+				const glm::vec2 center = m_bodies.positions[slot] + m_bodies.offsets[slot];
+				const glm::vec2 &halfSize = m_bodies.halfSizes[slot];
+				float distanceSq = DistanceSqToBox(point, center - halfSize, center + halfSize);
+				if (distanceSq > radiusSq)
+					return;
+
+				std::pair<float, uint32_t> entry{distanceSq, static_cast<uint32_t>(slot)};
+				if (heap.size() < k)
+				{
+					heap.push_back(entry);
+					std::push_heap(heap.begin(), heap.end(), farther);
+				}
+				else if (farther(entry, heap.front()))
+				{
+					std::pop_heap(heap.begin(), heap.end(), farther);
+					heap.back() = entry;
+					std::push_heap(heap.begin(), heap.end(), farther);
+				} });
+
+			if (heap.size() == k || radius >= limit)
+				break;
+			radius = std::min(radius * 2.0f, limit);
+		}
+
+		std::sort_heap(heap.begin(), heap.end(), farther);
+		for (const auto &entry : heap)
+			out.push_back(m_bodies.entities[entry.second]);
 	}
 }
@@ -7,9 +7,19 @@
 #include <engine/core/physics/CollisionDetection.hpp>
 #include <engine/core/physics/CollisionResolution.hpp>
 #include <engine/core/physics/CollisionShapes.hpp>
+#include <engine/core/physics/NarrowphaseBatch.hpp>
+#include <engine/core/physics/IntegrationBatch.hpp>
 #include <engine/core/physics/SpatialHashGrid.hpp>
+#include <engine/core/physics/SweepAndPrune.hpp>
+#include <engine/core/physics/AabbTreeBroadphase.hpp>
+#include <engine/core/physics/HierarchicalGrid.hpp>
+#include <engine/core/physics/PhysicsBodyStore.hpp>
+#include <engine/core/physics/ContactCache.hpp>
+#include <engine/core/physics/PhysicsSnapshot.hpp>
+#include <engine/core/physics/SpatialQuery.hpp>
 
 #include <engine/core/utils/Time.hpp>
+#include <engine/core/utils/ThreadPool.hpp>
 #include <engine/core/utils/Destruction.hpp>
 #include <extern/entt/entt.hpp>
 
@@ -17,8 +27,6 @@
 
 #include <engine/core/graphics/renderer/Renderer.hpp>
 
-#include <engine/core/ecs/ECS.hpp>
-
 namespace le
 {
 
@@ -58,37 +66,124 @@ namespace le
 
 		// Обновляет отладочную информацию: собирает коллайдеры и отправляет их в DebugRenderer
 		void Update(entt::registry &registry);
+
+		// Update по частям — для графа задач кадра:
+		// Collect только читает реестр (можно в рабочем потоке параллельно с другими
+		// читателями), Flush отправляет линии в OpenGL (поток контекста).
+		void Collect(const entt::registry &registry);
+		void Flush();
+
+	private:
+		// Линии последнего Collect: {x0, y0, r, g, b, x1, y1, r, g, b}
+		std::vector<float> m_lineVertices;
 	};
 
 	class CameraSystem
 	{
 	public:
-		void Update(entt::registry &registry, Renderer &renderer);
+		void Update(const entt::registry &registry, Renderer &renderer);
 	};
 
+	class PhysicsSystem;
+
 	class RenderSystem
 	{
 	public:
-		void Update();
+		// physics + alpha — отрисовка тел между двумя последними шагами физики
+		// (alpha = World::GetClock().InterpolationAlpha()). Без physics рисуется Transform как есть.
+		// Только ставит спрайты в очередь Renderer (OpenGL — в EndBatch) и реестр не меняет.
+		void Update(const entt::registry &registry, const PhysicsSystem *physics = nullptr, float alpha = 1.0f);
 	};
 
 	class ScriptSystem
 	{
 	public:
-		void Update();
-		void FixedUpdate();
+		void Update(entt::registry &registry);
+		void FixedUpdate(entt::registry &registry);
+
+		// Раздаёт события столкновений и триггеров последнего шага физики скриптам обеих
+		// сущностей пары (OnCollisionEnter/Exit, OnTriggerEnter/Exit). Вызывать после шага.
+		void DispatchCollisionEvents(entt::registry &registry, const PhysicsSystem &physics);
 	};
 
 	class DestroySystem
 	{
 	public:
-		static void Update();
+		// Отсчитывает DestroyTimer на deltaTime и удаляет истёкшие сущности
+		static void Update(entt::registry &registry, float deltaTime);
 	};
 
 	class PhysicsSystem
 	{
 	public:
-		PhysicsSystem(float worldWidth = 1000.0f, float worldHeight = 1000.0f, float cellSize = 100.0f);
+		// Событие шага для пары сущностей. Сущность могла быть удалена — проверяй valid().
+		struct CollisionEvent
+		{
+			enum class Type : uint8_t
+			{
+				CollisionEnter,
+				CollisionExit,
+				TriggerEnter,
+				TriggerExit
+			};
+
+			Type type;
+			entt::entity a;
+			entt::entity b;
+		};
+
+		// Итерации солвера на каждом острове: не меньше min и не больше max.
+		// Скоростные останавливаются, когда накопленные импульсы за итерацию меняются
+		// не больше impulseTolerance; позиционные — когда проникновение нигде не больше
+		// penetrationTolerance (при 0.005 — слоп resolvePosition — раньше выйти без потерь).
+		struct SolverSettings
+		{
+			int minVelocityIterations = 1;
+			int maxVelocityIterations = 12;
+			float impulseTolerance = 1e-3f;
+			int minPositionIterations = 1;
+			int maxPositionIterations = 4;
+			float penetrationTolerance = 0.005f;
+		};
+
+		// Сколько итераций солвер сделал в последнем шаге
+		struct SolverStats
+		{
+			size_t islands = 0;
+			size_t contacts = 0;
+			size_t velocityIterations = 0; // сумма по островам
+			size_t positionIterations = 0;
+			int maxVelocityIterations = 0; // больше всего на одном острове
+			int maxPositionIterations = 0;
+		};
+
+		// Поиск пар-кандидатов:
+		// HashGrid — равномерная сетка, хороша для тел одного размера (cellSize ~ размер тела);
+		// SweepAndPrune — сортировка по оси X, не зависит от размеров тел и пустого пространства;
+		// AabbTree — деревья AABB, сохраняемые между кадрами: лист переставляется, только когда
+		// тело вышло из толстых границ; пары ищут только бодрствующие тела;
+		// HierarchicalGrid — уровни сеток с ячейкой cellSize * 2^L, тело лежит в одной ячейке
+		// уровня по своему размеру — для миров, где рядом пули и боссы в тысячи пикселей.
+		// Статическая геометрия при любом выборе лежит в отдельной сетке, которая
+		// пересобирается только при изменении статики. Спящие тела в HashGrid,
+		// SweepAndPrune и HierarchicalGrid тоже не попадают — у них своя сетка, которую
+		// опрашивают только движущиеся тела, так что пары "сон против сна" не перебираются
+		// вовсе; AabbTree держит спящих в дереве, но пар для них не ищет.
+		enum class Broadphase
+		{
+			HashGrid,
+			SweepAndPrune,
+			AabbTree,
+			HierarchicalGrid
+		};
+
+		PhysicsSystem(float worldWidth = 1000.0f, float worldHeight = 1000.0f, float cellSize = 100.0f,
+					  Broadphase broadphase = Broadphase::HashGrid);
+		~PhysicsSystem();
+
+		// Хранилище тел подписано на сигналы реестра — систему нельзя копировать
+		PhysicsSystem(const PhysicsSystem &) = delete;
+		PhysicsSystem &operator=(const PhysicsSystem &) = delete;
 
 		void Update(entt::registry &registry, float dt);
 
@@ -98,15 +193,302 @@ namespace le
 			m_worldHeight = height;
 		}
 
+		// Поправка к Transform::position для отрисовки на доле alpha между предыдущим
+		// и последним шагом: position + offset. Для тел вне физики — ноль.
+		glm::vec2 GetInterpolationOffset(entt::entity entity, float alpha) const;
+
+		// Контакты между кадрами: импульсы + какие пары начали/перестали касаться
+		const ContactCache &GetContacts() const { return m_contactCache; }
+		// Пересечения с триггерами (импульсы всегда нулевые)
+		const ContactCache &GetTriggerContacts() const { return m_triggerCache; }
+
+		// События последнего шага: сначала выходы, затем входы; внутри — по ключу пары.
+		// Очищаются в начале следующего Update.
+		const std::vector<CollisionEvent> &GetEvents() const { return m_events; }
+
+		// Поиск пар по ячейкам сетки в пуле потоков (для сцен от k_parallelMinBodies тел).
+		// Результат не зависит от числа потоков.
+		void SetParallelBroadphase(bool enabled) { m_parallelBroadphase = enabled; }
+		bool GetParallelBroadphase() const { return m_parallelBroadphase; }
+
+		// Решение независимых островов контактов в пуле потоков.
+		// Результат совпадает с последовательным солвером бит в бит.
+		void SetParallelSolver(bool enabled) { m_parallelSolver = enabled; }
+		bool GetParallelSolver() const { return m_parallelSolver; }
+
+		// Сон: тела, которые k_timeToSleep секунд движутся медленнее k_sleepVelocity,
+		// засыпают вместе со своим островом контактов и не тратят время шага
+		void SetSleepEnabled(bool enabled) { m_sleepEnabled = enabled; }
+		bool GetSleepEnabled() const { return m_sleepEnabled; }
+
+		// Отрицательные счётчики обнуляются, max поднимается до min
+		void SetSolverSettings(const SolverSettings &settings);
+		const SolverSettings &GetSolverSettings() const { return m_solverSettings; }
+		const SolverStats &GetSolverStats() const { return m_solverStats; }
+
+		Broadphase GetBroadphase() const { return m_broadphase; }
+
+		// Сколько раз пересобиралось разбиение статики (только при изменении статики)
+		size_t GetStaticRebuildCount() const { return m_staticRebuildCount; }
+		// Ударов, найденных CCD за последний шаг
+		size_t GetContinuousHitCount() const { return m_continuousHitCount; }
+
+		// === Снимки (откат для сетевой игры, перемотка) ===
+		// Сохраняет состояние симуляции после последнего шага — вызывай сразу после Update.
+		// base — полный снимок из того же мира: тогда пишутся только изменения относительно
+		// него. Если base сам дельта, снимок сохраняется полным.
+		void SaveSnapshot(PhysicsSnapshot &snapshot, const PhysicsSnapshot *base = nullptr);
+		// Возвращает тела и кэши контактов к снимку и записывает их в компоненты; следующие
+		// Update повторят симуляцию бит в бит. Для дельты нужен тот же base, что при сохранении.
+		// Тела, появившиеся после снимка, не трогаются, удалённые — пропускаются; в этих
+		// случаях (и если снимок не подошёл) возвращается false.
+		bool RestoreSnapshot(entt::registry &registry, const PhysicsSnapshot &snapshot,
+							 const PhysicsSnapshot *base = nullptr);
+
+		// === Пространственные запросы ===
+		// Отвечают по телам с коллайдером на конец последнего шага: статика берётся из её
+		// сетки, подвижные тела — из сетки запросов, которая строится при первом запросе
+		// после шага. Поэтому методы не const и из нескольких потоков сразу не вызываются —
+		// для тысяч запросов есть RaycastBatch, он сам раскладывает их по пулу потоков.
+		// Ближайшее попадание на отрезке from -> to. Тела, внутри которых начинается луч, не считаются.
+		bool Raycast(const glm::vec2 &from, const glm::vec2 &to, RaycastHit &hit, const QueryFilter &filter = {});
+		// true, если отрезок ничего не задевает (останавливается на первом попадании)
+		bool LineOfSight(const glm::vec2 &from, const glm::vec2 &to, const QueryFilter &filter = {});
+		// hits[i] для rays[i]; anyHit — любое попадание вместо ближайшего (проверки видимости)
+		void RaycastBatch(const Ray *rays, size_t count, RaycastHit *hits, const QueryFilter &filter = {},
+						  bool anyHit = false);
+
+		// Сущности, чьи AABB (у повёрнутых ящиков — описанные) пересекают прямоугольник / круг /
+		// содержат точку (касание считается). Результат добавляется в out.
+		void OverlapBox(const glm::vec2 &center, const glm::vec2 &halfSize, std::vector<entt::entity> &out,
+						const QueryFilter &filter = {});
+		void OverlapCircle(const glm::vec2 &center, float radius, std::vector<entt::entity> &out,
+						   const QueryFilter &filter = {});
+		void QueryPoint(const glm::vec2 &point, std::vector<entt::entity> &out, const QueryFilter &filter = {});
+		// До k ближайших к point сущностей (по расстоянию до AABB) не дальше maxDistance,
+		// от ближней к дальней. out перезаписывается.
+		void FindNearest(const glm::vec2 &point, size_t k, std::vector<entt::entity> &out,
+						 float maxDistance = std::numeric_limits<float>::infinity(), const QueryFilter &filter = {});
+
 	private:
-		void IntegratePositions(entt::registry &registry, float dt);
-		void UpdateBroadPhase(entt::registry &registry);
-		void ResolveCollisions(entt::registry &registry, float dt);
-		void ResolveWorldBounds(entt::registry &registry);
+		// Контакт между двумя слотами хранилища тел
+		struct CollisionPair
+		{
+			size_t i, j;
+			Contact contact;
+			float restitution, friction;
+			float baseSeparation = 0.0f; // dot(posA - posB, normal) в момент обнаружения
+			bool isTrigger = false;		 // хотя бы один коллайдер — триггер: только события
+			bool isContinuous = false;	 // быстрое тело против другого: решается через TOI, не солвером
+		};
+
+		void IntegratePositions(float dt);
+		// Пара фигур кандидата — корзина narrowphase
+		enum ShapePair : uint8_t
+		{
+			BoxPair,		 // оба ящика не повёрнуты — пакетно (SIMD)
+			OrientedBoxPair, // хотя бы один ящик повёрнут — SAT
+			BoxCirclePair,
+			CirclePair,
+			k_shapePairCount
+		};
+
+		// Кандидаты narrowphase одного куска сетки, разложенные по корзинам фигур
+		struct CandidateBatch
+		{
+			std::vector<uint32_t> slotsA, slotsB; // все кандидаты в порядке broadphase
+			std::vector<uint8_t> shapePairs;	  // ShapePair кандидата
+			std::vector<uint32_t> buckets[k_shapePairCount]; // индексы кандидатов по корзинам
+			AabbPairBatch aabbs;							 // корзина BoxPair в SoA для пакетной проверки
+			std::vector<uint32_t> hits[k_shapePairCount];	 // пересекающиеся кандидаты корзины, по возрастанию
+			std::vector<Contact> contacts[k_shapePairCount]; // их контакты
+		};
+
+		// Пересобирает сетку статики, если статика изменилась с прошлой сборки
+		void UpdateStaticPartition();
+		// То же для спящих тел (кроме AabbTree): сон, пробуждение или сдвиг спящего
+		void UpdateSleepPartition();
+		// Заполняет выбранный broadphase границами подвижных тел (с путём за dt)
+		void UpdateBroadphase(float dt);
+		// Единицы обхода: сначала подвижного broadphase, затем запросы бодрствующих тел к статике,
+		// затем запросы движущихся тел к спящим
+		size_t BroadphaseRangeCount() const;
+		// Ячеек сетки, прокси sweep-and-prune или запросов к деревьям
+		size_t DynamicRangeCount() const;
+		size_t BroadphaseMinRangePerChunk() const;
+		// Пары broadphase из единиц [rangeBegin, rangeEnd), где хотя бы одно тело движется
+		void CollectCandidates(size_t rangeBegin, size_t rangeEnd, CandidateBatch &batch) const;
+		// Narrowphase пакета кандидатов; контакты добавляются в out в порядке кандидатов
+		void FindContacts(CandidateBatch &batch, std::vector<CollisionPair> &out) const;
+		// Корзина пары: по числу кругов, пара ящиков — по повороту
+		ShapePair ShapePairOf(size_t i, size_t j) const;
+		// Ящик слота в мировых осях для SAT
+		Obb OrientedBox(size_t slot) const;
+		Circle CircleOf(size_t slot) const;
+
+		// Корзины narrowphase: каждая — однородным циклом, контакты в hits / contacts корзины
+		void CollideBoxes(CandidateBatch &batch) const;
+		void CollideOrientedBoxes(CandidateBatch &batch) const;
+		void CollideBoxCircles(CandidateBatch &batch) const;
+		void CollideCircles(CandidateBatch &batch) const;
+		template <typename Test>
+		void CollideBucket(CandidateBatch &batch, ShapePair type, Test &&test) const
+		{
+			auto &hits = batch.hits[type];
+			auto &contacts = batch.contacts[type];
+			hits.clear();
+			contacts.clear();
+
+			for (uint32_t k : batch.buckets[type])
+			{
+				Contact contact = test(batch.slotsA[k], batch.slotsB[k]);
+				if (!contact.intersecting)
+					continue;
+				hits.push_back(k);
+				contacts.push_back(contact);
+			}
+		}
+
+		// AABB тел пересекались строго в начале шага (до интеграции)
+		bool OverlappedAtStepStart(size_t i, size_t j) const;
+		void ResolveCollisions(float dt);
+
+		// Разбивает контакты m_pairs на острова без общих динамических тел
+		void BuildIslands();
+		uint32_t FindIslandRoot(uint32_t slot);
+		// Warm start, скоростные и позиционные итерации одного острова.
+		// Сколько итераций понадобилось — в m_islandIterations[island].
+		void SolveIsland(uint32_t island);
+		// Записывает результат солвера только в динамические тела пары
+		void StoreIfDynamic(const CollisionPair &pair, std::vector<glm::vec2> &values,
+							const glm::vec2 &valueA, const glm::vec2 &valueB) const;
+		void ResolveWorldBounds();
+
+		// Таймеры покоя и усыпление островов солвера
+		void UpdateSleep(float dt);
+
+		// Убирает из m_pairs пары для CCD и раскладывает их по быстрым телам
+		void ExtractContinuousPairs();
+		// CCD: быстрые тела проходят путь шага подшагами от одного удара (TOI) до следующего
+		void SolveContinuous(float dt);
+
+		// Убирает пары с триггерами из m_pairs и сверяет их с прошлым шагом
+		void ExtractTriggerPairs();
+		// События шага из начавшихся и закончившихся пар обоих кэшей
+		void CollectEvents();
+		// Пара прошлого кадра не проверялась из-за сна — она не закончилась
+		bool IsRetainedBySleep(uint64_t key) const;
+
+		// Пересобирает устаревшие сетки запросов (статики и подвижных тел)
+		void PrepareQueries();
+		bool PassesFilter(size_t slot, const QueryFilter &filter) const;
+		// Обход обеих сеток; callback(slot)
+		template <typename Callback>
+		void ForEachQueryBodyInRange(const glm::vec2 &minCorner, const glm::vec2 &maxCorner, Callback &&callback) const
+		{
+			m_staticGrid.ForEachInRange(minCorner, maxCorner, callback);
+			m_queryGrid.ForEachInRange(minCorner, maxCorner, callback);
+		}
+		// Raycast по уже подготовленным сеткам — только чтение, можно из нескольких потоков
+		void RaycastPrepared(const Ray &ray, RaycastHit &hit, const QueryFilter &filter, bool anyHit) const;
 
 		float m_worldWidth;
 		float m_worldHeight;
+		Broadphase m_broadphase;
 		SpatialHashGrid m_grid;
+		SweepAndPrune m_sweepAndPrune;
+		AabbTreeBroadphase m_aabbTree;
+		HierarchicalGrid m_hierarchicalGrid;
+
+		// Статическая геометрия — в своей сетке, которая живёт между кадрами
+		SpatialHashGrid m_staticGrid;
+		bool m_staticGridBuilt = false;
+		uint32_t m_staticGridVersion = 0;
+		size_t m_staticRebuildCount = 0;
+		uint32_t m_staticCategories = 0; // объединение слоёв статики
+		std::vector<uint32_t> m_staticQueries; // бодрствующие тела кадра
+		std::vector<glm::vec2> m_staticQueryMins, m_staticQueryMaxs;
+		size_t m_dynamicRangeCount = 0;
+
+		// Спящие тела (кроме AabbTree) — тоже в своей сетке: пары с ними ищут движущиеся тела
+		SpatialHashGrid m_sleepGrid;
+		bool m_sleepGridBuilt = false;
+		uint32_t m_sleepGridVersion = 0;
+		uint32_t m_sleepGridLayout = 0;
+		uint32_t m_sleepCategories = 0; // объединение слоёв спящих тел
+		std::vector<uint32_t> m_sleepQueries; // движущиеся тела кадра
+		std::vector<glm::vec2> m_sleepQueryMins, m_sleepQueryMaxs;
+
+		// Запросы: сетка подвижных тел по позициям конца шага
+		SpatialHashGrid m_queryGrid;
+		bool m_queryGridBuilt = false;
+		uint64_t m_queryGridStep = 0;
+		uint32_t m_queryGridLayout = 0;
+		uint64_t m_stepCount = 0;
+		static constexpr size_t k_minRaysPerChunk = 256;
+		std::vector<std::pair<float, uint32_t>> m_nearestHeap; // (расстояние, слот), max-heap
+		PhysicsBodyStore m_bodies;
+		std::vector<CollisionPair> m_pairs; // переиспользуется между кадрами
+
+		// CCD: тело идёт через TOI, если оно пуля или прошло за шаг больше
+		// k_continuousMotion своего наименьшего размера
+		static constexpr float k_continuousMotion = 0.5f;
+		static constexpr int k_maxToiSubSteps = 8; // ударов за шаг; дальше тело стоит до конца шага
+		static constexpr float k_toiSlop = 0.01f;  // зазор, на котором тело останавливается перед ударом
+		std::vector<uint8_t> m_continuous;		   // по слотам: тело идёт через CCD в этом шаге
+		std::vector<std::pair<uint32_t, uint32_t>> m_continuousTargets; // (быстрое тело, другое), по первому
+		size_t m_continuousHitCount = 0;
+
+		// Интегратор упирается в память — тела делятся на крупные куски
+		static constexpr size_t k_minBodiesPerIntegrateChunk = 8192;
+
+		// Параллельный broadphase: буфер пар на каждый кусок ячеек / прокси / запросов / объектов
+		static constexpr size_t k_parallelMinBodies = 512;
+		static constexpr size_t k_minCellsPerChunk = 64;
+		static constexpr size_t k_minProxiesPerChunk = 128;
+		static constexpr size_t k_minQueriesPerChunk = 64;
+		static constexpr size_t k_minItemsPerChunk = 128;
+		bool m_parallelBroadphase = true;
+		std::vector<std::vector<CollisionPair>> m_pairBuffers;
+		std::vector<CandidateBatch> m_candidateBuffers;
+
+		// Параллельный солвер: контакты, сгруппированные по островам
+		static constexpr size_t k_parallelMinContacts = 256;
+		bool m_parallelSolver = true;
+		std::vector<uint32_t> m_islandParents;	// union-find по слотам тел
+		std::vector<uint32_t> m_islandOfRoot;	// корень -> номер острова
+		std::vector<uint32_t> m_contactIslands; // остров контакта
+		std::vector<uint32_t> m_islandContacts; // индексы контактов, сгруппированные по острову
+		std::vector<uint32_t> m_islandOffsets;	// начало острова в m_islandContacts
+		std::vector<uint32_t> m_islandFill;		// курсоры записи при группировке
+		std::vector<uint32_t> m_islandOrder;	// острова от крупных к мелким
+		std::vector<std::pair<int, int>> m_islandIterations; // (скоростных, позиционных) по острову
+		SolverSettings m_solverSettings;
+		SolverStats m_solverStats;
+
+		// Сон
+		static constexpr float k_sleepVelocity = 5.0f; // пикселей в секунду
+		static constexpr float k_timeToSleep = 0.5f;	 // секунд
+		bool m_sleepEnabled = true;
+		std::vector<float> m_islandSleepTimes; // минимальный таймер покоя острова (по корню)
+
+		// Данные контактов шага, параллельные m_pairs
+		ContactCache m_contactCache;
+		std::vector<uint64_t> m_contactKeys;
+		std::vector<glm::vec2> m_contactNormals;
+		std::vector<float> m_normalImpulses;
+		std::vector<float> m_tangentImpulses;
+		std::vector<float> m_velocityBiases;
+
+		// Триггеры и события
+		ContactCache m_triggerCache;
+		std::vector<uint64_t> m_triggerKeys;
+		std::vector<glm::vec2> m_triggerNormals;
+		std::vector<float> m_triggerImpulses; // не используются — кэш требует массивы
+		std::vector<CollisionEvent> m_events;
+
+		// Снимки
+		std::vector<uint8_t> m_snapshotImage; // образ перед кодированием / после раскодирования дельты
 	};
 
 }
@@ -0,0 +1,48 @@
+#include <engine/core/World.hpp>
+
+namespace le
+{
+	World::World() : World(Settings{}) {}
+
+	World::World(const Settings &settings)
+		: m_physics(settings.width, settings.height, settings.cellSize, settings.broadphase)
+	{
+		m_clock.SetFixedDeltaTime(settings.fixedDeltaTime);
+		m_clock.SetMaxFixedSteps(settings.maxFixedSteps);
+
+		// По нему скрипты находят свой мир
+		m_registry.ctx().emplace<World *>(this);
+	}
+
+	World *World::Of(const entt::registry &registry)
+	{
+		World *const *world = registry.ctx().find<World *>();
+		return world != nullptr ? *world : nullptr;
+	}
+
+	void World::Step(float deltaTime)
+	{
+		m_clock.Advance(deltaTime);
+
+		// Физика и FixedUpdate — фиксированными шагами, сколько накопилось за кадр
+		const int fixedSteps = m_clock.ConsumeFixedSteps();
+		for (int step = 0; step < fixedSteps; ++step)
+			FixedStep();
+
+		DestroySystem::Update(m_registry, m_clock.DeltaTime());
+		m_scripts.Update(m_registry);
+	}
+
+	void World::FixedStep()
+	{
+		m_scripts.FixedUpdate(m_registry);
+		m_physics.Update(m_registry, m_clock.FixedDeltaTime());
+		m_scripts.DispatchCollisionEvents(m_registry, m_physics);
+	}
+
+	void World::StepAll(const std::vector<World *> &worlds, float deltaTime, utils::ThreadPool &pool)
+	{
+		pool.Run(worlds.size(), [&](size_t i)
+				 { worlds[i]->Step(deltaTime); });
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include <extern/entt/entt.hpp>
+
+#include <engine/core/Systems.hpp>
+#include <engine/core/events/InputState.hpp>
+#include <engine/core/utils/Clock.hpp>
+#include <engine/core/utils/ThreadPool.hpp>
+
+namespace le
+{
+	/**
+	 * @brief Независимый мир: свой реестр, физика, скрипты, время и ввод.
+	 *
+	 * Всё состояние симуляции живёт в мире, а не в синглтонах — в одном процессе может
+	 * идти сколько угодно миров (выделенный сервер с десятками матчей). Step() не трогает
+	 * OpenGL, окно и Renderer: мир без окна (headless) не требует GL-контекста.
+	 * Отрисовку делает тот, у кого окно (Engine), — RenderSystem над GetRegistry().
+	 *
+	 * Скрипты находят свой мир по реестру (ScriptComponent::world(), World::Of) и берут
+	 * время и ввод оттуда. Разные миры не делят изменяемых данных, поэтому их можно
+	 * шагать одновременно (StepAll); один мир — только из одного потока за раз.
+	 */
+	class World
+	{
+	public:
+		struct Settings
+		{
+			// Физика (см. PhysicsSystem)
+			float width = 1000.0f;
+			float height = 1000.0f;
+			float cellSize = 100.0f;
+			PhysicsSystem::Broadphase broadphase = PhysicsSystem::Broadphase::HashGrid;
+
+			// Время (см. utils::Clock)
+			float fixedDeltaTime = 1.0f / 60.0f;
+			int maxFixedSteps = 5;
+		};
+
+		World();
+		explicit World(const Settings &settings);
+		// Скрипты и подписки физики ссылаются на мир по адресу — ни копировать, ни перемещать
+		World(const World &) = delete;
+		World &operator=(const World &) = delete;
+
+		entt::registry &GetRegistry() { return m_registry; }
+		const entt::registry &GetRegistry() const { return m_registry; }
+		PhysicsSystem &GetPhysics() { return m_physics; }
+		const PhysicsSystem &GetPhysics() const { return m_physics; }
+		ScriptSystem &GetScripts() { return m_scripts; }
+		utils::Clock &GetClock() { return m_clock; }
+		const utils::Clock &GetClock() const { return m_clock; }
+		// Ввод игрока этого мира: перед Step — BeginFrame() и SetKey(...)
+		InputState &GetInput() { return m_input; }
+		const InputState &GetInput() const { return m_input; }
+
+		// Мир, которому принадлежит реестр; nullptr — реестр создан не миром
+		static World *Of(const entt::registry &registry);
+
+		// Кадр длительностью deltaTime без отрисовки: накопившиеся фиксированные шаги,
+		// затем удаление сущностей по DestroyTimer и Update скриптов
+		void Step(float deltaTime);
+		// Один фиксированный шаг: FixedUpdate скриптов → физика → события столкновений
+		void FixedStep();
+
+		// Шагает миры параллельно, по задаче на мир. Параллельные циклы физики внутри
+		// мира идут в ThreadPool::Get(): если pool — он же, освободившиеся потоки
+		// помогают мирам, которые шагают дольше.
+		static void StepAll(const std::vector<World *> &worlds, float deltaTime,
+							utils::ThreadPool &pool = utils::ThreadPool::Get());
+
+	private:
+		// Реестр объявлен первым: физика отписывается от него в деструкторе
+		entt::registry m_registry;
+		PhysicsSystem m_physics;
+		ScriptSystem m_scripts;
+		utils::Clock m_clock;
+		InputState m_input;
+	};
+}
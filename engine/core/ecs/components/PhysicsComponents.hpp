@@ -2,12 +2,15 @@
 
 #include <glm/glm.hpp>
 #include <algorithm>
+#include <cstdint>
 
 namespace le
 {
 
 	// ============================================================================
 	// Rigidbody2D — физическое тело
+	// PhysicsSystem кэширует массу, флаги, упругость и трение. Если меняешь их
+	// во время игры — вызови registry.patch<Rigidbody2D>(entity).
 	// ============================================================================
 	struct Rigidbody2D
 	{
@@ -16,6 +19,10 @@ namespace le
 		glm::vec2 acceleration{0.0f}; // текущее ускорение (сумма сил / масса)
 		float restitution{0.8f};	  // упругость: [0.0 = полностью поглощает, 1.0 = идеальный отскок]
 		float friction{0.5f};		  // трение: [0.0 = лёд, 1.0 = резина]
+		// Пуля: всегда проверяется непрерывно (CCD) и не проходит сквозь тонкие стены на любой
+		// скорости. Без флага CCD включается только для тел, прошедших за шаг больше
+		// половины своего наименьшего размера.
+		bool isBullet{false};
 
 		// Конструктор для удобства
 		Rigidbody2D(float m = 1.0f, float rest = 0.8f, float fric = 0.5f)
@@ -55,12 +62,12 @@ namespace le
 			}
 		}
 
-		bool GetKinematic()
+		bool GetKinematic() const
 		{
 			return isKinematic;
 		}
 
-		bool GetStatic()
+		bool GetStatic() const
 		{
 			return isStatic;
 		}
@@ -70,22 +77,46 @@ namespace le
 			return inverseMass;
 		}
 
+		// Спящее тело не интегрируется и не участвует в поиске пар. Просыпается само,
+		// когда его касается движущееся тело или ему задают скорость / ускорение.
+		bool IsSleeping() const
+		{
+			return isSleeping;
+		}
+
+		void SetSleeping(bool sleeping)
+		{
+			isSleeping = sleeping;
+		}
+
+		void WakeUp()
+		{
+			isSleeping = false;
+		}
+
 	private:
 		bool isKinematic{false}; // если true — не реагирует на силы, но может двигаться вручную
 		bool isStatic{false};	 // если true — никогда не двигается (mass = 0)
+		bool isSleeping{false};	 // тело в покое усыплено PhysicsSystem вместе со своим островом
 
 		float mass{1.0f};		 // масса (> 0). Если 0 — тело статическое.
 		float inverseMass{1.0f}; // кэшированная 1/mass (для оптимизации)
 	};
 
 	// ============================================================================
-	// BoxCollider2D — прямоугольный коллайдер (AABB)
+	// BoxCollider2D — прямоугольный коллайдер. Поворачивается вокруг Transform::position
+	// на Transform::rotation (градусы) вместе с offset; физика сама тело не вращает.
+	// Изменения размера/смещения/слоёв во время игры — через registry.patch<BoxCollider2D>(entity).
+	// Слои: пара проверяется, только если categoryBits каждого коллайдера есть в maskBits
+	// другого. Например, пули: categoryBits = 0x2, maskBits = ~0x2u — друг друга не трогают.
 	// ============================================================================
 	struct BoxCollider2D
 	{
 		glm::vec2 size{100.0f, 100.0f}; // ПОЛНЫЙ размер (ширина × высота)
 		glm::vec2 offset{0.0f, 0.0f};	// смещение относительно Transform.position
 		bool isTrigger{false};			// триггер: вызывает события, но не физику
+		uint32_t categoryBits{0x0001};	// слои, в которых лежит коллайдер
+		uint32_t maskBits{0xFFFFFFFF};	// слои, с которыми он сталкивается
 
 		// Вспомогательные методы (можно вынести в утилиты, но удобно здесь)
 		glm::vec2 halfSize() const
@@ -98,13 +129,17 @@ namespace le
 	};
 
 	// ============================================================================
-	// CircleCollider2D — круговой коллайдер
+	// CircleCollider2D — круговой коллайдер. offset поворачивается вместе с Transform::rotation,
+	// изменения во время игры — через registry.patch<CircleCollider2D>(entity).
+	// Если на сущности есть и BoxCollider2D, физика берёт ящик.
 	// ============================================================================
 	struct CircleCollider2D
 	{
 		float radius{0.5f};			  // радиус (> 0)
 		glm::vec2 offset{0.0f, 0.0f}; // смещение относительно Transform.position
 		bool isTrigger{false};
+		uint32_t categoryBits{0x0001}; // слои — как у BoxCollider2D
+		uint32_t maskBits{0xFFFFFFFF};
 
 		CircleCollider2D(float r = 0.5f) : radius(std::max(r, 0.001f)) {}
 	};
@@ -1,5 +1,6 @@
 #include <engine/core/ecs/components/ScriptComponent.hpp>
 #include <engine/core/scene/Object.hpp> // Теперь можно включать — нет цикла
+#include <engine/core/World.hpp>
 
 Object ScriptComponent::gameObject()
 {
@@ -10,3 +11,29 @@ Object ScriptComponent::gameObject()
 	}
 	return Object(*registry, entity);
 }
+
+le::World &ScriptComponent::world()
+{
+	le::World *owner = registry != nullptr ? le::World::Of(*registry) : nullptr;
+	if (owner == nullptr)
+	{
+		utils::Logger::error("ScriptComponent registry does not belong to a World!");
+		throw std::runtime_error("Registry without World");
+	}
+	return *owner;
+}
+
+float ScriptComponent::DeltaTime()
+{
+	return world().GetClock().DeltaTime();
+}
+
+float ScriptComponent::FixedDeltaTime()
+{
+	return world().GetClock().FixedDeltaTime();
+}
+
+const InputState &ScriptComponent::Input()
+{
+	return world().GetInput();
+}
@@ -1,10 +1,16 @@
 #pragma once
 
 #include <engine/core/ecs/components/CoreComponents.hpp>
+#include <engine/core/events/InputState.hpp>
 #include <engine/core/utils/Logger.hpp>
 
 #include <extern/entt/entt.hpp>
 
+namespace le
+{
+	class World;
+}
+
 struct ScriptComponent
 {
 protected:
@@ -16,6 +22,13 @@ public:
 
 	Object gameObject();
 
+	// ! Мир скрипта: его время и ввод. Через них, а не через utils::Time и
+	// ! InputManager — в процессе может жить несколько миров.
+	le::World &world();
+	float DeltaTime();
+	float FixedDeltaTime();
+	const InputState &Input();
+
 	virtual ~ScriptComponent() = default;
 
 	virtual void Awake() {}
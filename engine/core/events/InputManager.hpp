@@ -1,8 +1,13 @@
 #pragma once
 
 #include <GLFW/glfw3.h>
-#include <unordered_map>
 
+#include <engine/core/events/InputState.hpp>
+
+static_assert(InputState::KeyCount == GLFW_KEY_LAST + 1, "InputState::KeyCount must cover all GLFW keys");
+
+// ! Опрос клавиатуры окна. Скрипты читают ввод своего мира (ScriptComponent::Input()),
+// ! Engine каждый кадр копирует туда GetState().
 class InputManager
 {
 public:
@@ -14,28 +19,18 @@ public:
 
 	void Update(GLFWwindow *window)
 	{
+		m_State.BeginFrame();
 		for (int i = 0; i <= GLFW_KEY_LAST; ++i)
 		{
-			m_PreviousKeys[i] = m_CurrentKeys[i];
-			m_CurrentKeys[i] = glfwGetKey(window, i) == GLFW_PRESS;
+			m_State.SetKey(i, glfwGetKey(window, i) == GLFW_PRESS);
 		}
 	}
 
-	bool IsKeyPressed(int key)
-	{
-		if (key >= 0 && key <= GLFW_KEY_LAST)
-			return m_CurrentKeys[key];
-		return false;
-	}
+	bool IsKeyPressed(int key) const { return m_State.IsKeyPressed(key); }
+	bool WasKeyPressed(int key) const { return m_State.WasKeyPressed(key); }
 
-	bool WasKeyPressed(int key)
-	{
-		if (key >= 0 && key <= GLFW_KEY_LAST)
-			return m_CurrentKeys[key] && !m_PreviousKeys[key];
-		return false;
-	}
+	const InputState &GetState() const { return m_State; }
 
 private:
-	std::unordered_map<int, bool> m_CurrentKeys;
-	std::unordered_map<int, bool> m_PreviousKeys;
+	InputState m_State;
 };
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <bitset>
+
+/**
+ * @brief Состояние клавиш одного мира — без GLFW.
+ *
+ * Коды клавиш — коды GLFW (GLFW_KEY_*). Окно заполняет состояние через InputManager,
+ * выделенный сервер — из команд игрока: BeginFrame(), затем SetKey для каждой клавиши.
+ */
+class InputState
+{
+public:
+	// GLFW_KEY_LAST + 1 (проверяется в InputManager.hpp)
+	static constexpr int KeyCount = 349;
+
+	// Текущие нажатия становятся предыдущими — перед тем, как записать новые
+	void BeginFrame() { m_PreviousKeys = m_CurrentKeys; }
+
+	void SetKey(int key, bool pressed)
+	{
+		if (key >= 0 && key < KeyCount)
+			m_CurrentKeys[key] = pressed;
+	}
+
+	void Clear()
+	{
+		m_CurrentKeys.reset();
+		m_PreviousKeys.reset();
+	}
+
+	bool IsKeyPressed(int key) const
+	{
+		if (key >= 0 && key < KeyCount)
+			return m_CurrentKeys[key];
+		return false;
+	}
+
+	bool WasKeyPressed(int key) const
+	{
+		if (key >= 0 && key < KeyCount)
+			return m_CurrentKeys[key] && !m_PreviousKeys[key];
+		return false;
+	}
+
+private:
+	std::bitset<KeyCount> m_CurrentKeys;
+	std::bitset<KeyCount> m_PreviousKeys;
+};
@@ -0,0 +1,90 @@
+// engine/core/physics/AabbTreeBroadphase.cpp
+#include "AabbTreeBroadphase.hpp"
+
+namespace le
+{
+
+	void AabbTreeBroadphase::BeginUpdate(size_t idCount)
+	{
+		++m_frame;
+		m_treeChanges = 0;
+		m_queries.clear();
+
+		// Прокси с id за границей удалятся в EndUpdate — пока массивы не укорачиваем
+		const size_t size = std::max(idCount, m_proxies.size());
+		m_boxes.resize(size);
+		m_proxies.resize(size);
+		m_stamps.resize(size, 0);
+		m_isQuery.assign(size, 0);
+	}
+
+	void AabbTreeBroadphase::SetBox(uint32_t id, const glm::vec2 &minCorner, const glm::vec2 &maxCorner,
+									bool isStatic, bool query)
+	{
+		m_boxes[id] = {minCorner, maxCorner};
+		m_stamps[id] = m_frame;
+
+		if (query)
+		{
+			m_isQuery[id] = 1;
+			m_queries.push_back(id);
+		}
+
+		Proxy &proxy = m_proxies[id];
+
+		// Тело стало статическим (или наоборот) — переезжает в другое дерево
+		if (proxy.node != DynamicAabbTree::k_nullNode && proxy.isStatic != isStatic)
+			DestroyProxy(id);
+
+		DynamicAabbTree &tree = isStatic ? m_staticTree : m_dynamicTree;
+		if (proxy.node == DynamicAabbTree::k_nullNode)
+		{
+			proxy.node = tree.CreateProxy(minCorner, maxCorner, id);
+			proxy.isStatic = isStatic;
+			++m_treeChanges;
+		}
+		else if (tree.MoveProxy(proxy.node, minCorner, maxCorner))
+		{
+			++m_treeChanges;
+		}
+	}
+
+	void AabbTreeBroadphase::EndUpdate()
+	{
+		// Убираем прокси, которые в этом кадре не обновлялись
+		size_t idCount = 0;
+		for (uint32_t id = 0; id < m_proxies.size(); ++id)
+		{
+			if (m_stamps[id] == m_frame)
+				idCount = id + 1;
+			else if (m_proxies[id].node != DynamicAabbTree::k_nullNode)
+				DestroyProxy(id);
+		}
+
+		m_boxes.resize(idCount);
+		m_proxies.resize(idCount);
+		m_stamps.resize(idCount);
+		m_isQuery.resize(idCount);
+	}
+
+	void AabbTreeBroadphase::DestroyProxy(uint32_t id)
+	{
+		Proxy &proxy = m_proxies[id];
+		(proxy.isStatic ? m_staticTree : m_dynamicTree).DestroyProxy(proxy.node);
+		proxy.node = DynamicAabbTree::k_nullNode;
+		++m_treeChanges;
+	}
+
+	void AabbTreeBroadphase::Clear()
+	{
+		m_staticTree.Clear();
+		m_dynamicTree.Clear();
+		m_boxes.clear();
+		m_proxies.clear();
+		m_stamps.clear();
+		m_isQuery.clear();
+		m_queries.clear();
+		m_treeChanges = 0;
+	}
+
+} // namespace le
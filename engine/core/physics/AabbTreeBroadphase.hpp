@@ -0,0 +1,124 @@
+// engine/core/physics/AabbTreeBroadphase.hpp
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glm/vec2.hpp>
+
+#include <engine/core/physics/DynamicAabbTree.hpp>
+
+namespace le
+{
+
+	/**
+	 * @brief Broadphase на двух динамических деревьях AABB.
+	 *
+	 * Неподвижные для солвера прокси (статика, кинематика) живут в своём дереве,
+	 * подвижные — в своём. Прокси сохраняются между кадрами: SetBox переставляет
+	 * лист, только если тело вышло из толстых границ, так что тысячи стен
+	 * дерево не перестраивают. Пары ищут только прокси с query = true
+	 * (бодрствующие тела) — по одному запросу в каждое дерево.
+	 *
+	 * Кадр: BeginUpdate → SetBox для всех живых прокси → EndUpdate → ForEachPair.
+	 * Прокси, не получившие SetBox в этом кадре, удаляются.
+	 */
+	class AabbTreeBroadphase
+	{
+	public:
+		explicit AabbTreeBroadphase(float margin = 8.0f) : m_staticTree(margin), m_dynamicTree(margin) {}
+
+		// idCount — верхняя граница id в этом кадре
+		void BeginUpdate(size_t idCount);
+		// isStatic — тело не двигает солвер; query — тело ищет себе пары
+		void SetBox(uint32_t id, const glm::vec2 &minCorner, const glm::vec2 &maxCorner, bool isStatic, bool query);
+		void EndUpdate();
+		void Clear();
+
+		size_t QueryCount() const { return m_queries.size(); }
+		size_t ProxyCount() const { return m_staticTree.ProxyCount() + m_dynamicTree.ProxyCount(); }
+		// Сколько листов переставлено в последнем кадре (вставки, перемещения, удаления)
+		size_t TreeChangeCount() const { return m_treeChanges; }
+
+		const DynamicAabbTree &GetStaticTree() const { return m_staticTree; }
+		const DynamicAabbTree &GetDynamicTree() const { return m_dynamicTree; }
+
+		// Все пары с пересекающимися AABB (касание считается), где хотя бы один прокси
+		// ищет пары, — каждая один раз. callback(a, b): a < b.
+		template <typename Callback>
+		void ForEachPair(Callback &&callback) const
+		{
+			ForEachPairInRange(0, QueryCount(), std::forward<Callback>(callback));
+		}
+
+		// Пары запросов [begin, end) в порядке SetBox. Деревья только читаются —
+		// непересекающиеся диапазоны можно обходить из нескольких потоков.
+		template <typename Callback>
+		void ForEachPairInRange(size_t begin, size_t end, Callback &&callback) const
+		{
+			end = std::min(end, m_queries.size());
+
+			// Соседи запроса сортируются по id: форма деревьев зависит от истории вставок,
+			// а порядок пар — нет. Тогда и солвер, и восстановленный снимок дают тот же результат.
+			thread_local std::vector<uint32_t> others;
+
+			for (size_t k = begin; k < end; ++k)
+			{
+				const uint32_t id = m_queries[k];
+				const Box &box = m_boxes[id];
+
+				others.clear();
+				auto report = [&](uint32_t other)
+				{
+					if (other == id)
+						return;
+					// Пару двух запросов сообщает только меньший id
+					if (m_isQuery[other] && other < id)
+						return;
+
+					// Толстые границы дерева шире настоящих — отсекаем лишнее
+					const Box &otherBox = m_boxes[other];
+					if (box.maxCorner.x < otherBox.minCorner.x || box.minCorner.x > otherBox.maxCorner.x ||
+						box.maxCorner.y < otherBox.minCorner.y || box.minCorner.y > otherBox.maxCorner.y)
+						return;
+
+					others.push_back(other);
+				};
+
+				m_staticTree.Query(box.minCorner, box.maxCorner, report);
+				m_dynamicTree.Query(box.minCorner, box.maxCorner, report);
+
+				std::sort(others.begin(), others.end());
+				for (uint32_t other : others)
+					callback(static_cast<size_t>(std::min(id, other)), static_cast<size_t>(std::max(id, other)));
+			}
+		}
+
+	private:
+		struct Box
+		{
+			glm::vec2 minCorner;
+			glm::vec2 maxCorner;
+		};
+
+		struct Proxy
+		{
+			int32_t node = DynamicAabbTree::k_nullNode;
+			bool isStatic = false;
+		};
+
+		void DestroyProxy(uint32_t id);
+
+		DynamicAabbTree m_staticTree;
+		DynamicAabbTree m_dynamicTree;
+
+		std::vector<Box> m_boxes;		// по id, настоящие границы этого кадра
+		std::vector<Proxy> m_proxies;	// по id — сохраняется между кадрами
+		std::vector<uint32_t> m_stamps; // кадр последнего SetBox
+		std::vector<uint8_t> m_isQuery; // id ищет пары в этом кадре
+		std::vector<uint32_t> m_queries;
+		uint32_t m_frame = 0;
+		size_t m_treeChanges = 0;
+	};
+
+} // namespace le
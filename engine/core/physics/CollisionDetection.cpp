@@ -2,6 +2,8 @@
 #include "CollisionDetection.hpp"
 #include <cmath>
 #include <algorithm>
+#include <limits>
+#include <glm/common.hpp>
 #include <glm/geometric.hpp>
 
 namespace le
@@ -40,6 +42,9 @@ namespace le
 		}
 		else
 		{
+			// По оси не движемся — удар возможен, только если проекции уже перекрыты
+			if (aMaxX <= bMinX || aMinX >= bMaxX)
+				return result;
 			xEntry = -std::numeric_limits<float>::max();
 			xExit = std::numeric_limits<float>::max();
 		}
@@ -58,6 +63,9 @@ namespace le
 		}
 		else
 		{
+			// По оси не движемся — удар возможен, только если проекции уже перекрыты
+			if (aMaxY <= bMinY || aMinY >= bMaxY)
+				return result;
 			yEntry = -std::numeric_limits<float>::max();
 			yExit = std::numeric_limits<float>::max();
 		}
@@ -120,51 +128,212 @@ namespace le
 			contact.normal = (a.center.y < b.center.y) ? glm::vec2(0, -1) : glm::vec2(0, 1);
 		}
 
-		// Точка контакта — центр пересечения
+		// Точка контакта — центр пересечения, манифолд — концы его средней линии вдоль грани
 		glm::vec2 overlapMin = glm::max(minA, minB);
 		glm::vec2 overlapMax = glm::min(maxA, maxB);
 		contact.point = (overlapMin + overlapMax) * 0.5f;
+		if (overlapX < overlapY)
+		{
+			contact.points[0] = {contact.point.x, overlapMin.y};
+			contact.points[1] = {contact.point.x, overlapMax.y};
+		}
+		else
+		{
+			contact.points[0] = {overlapMin.x, contact.point.y};
+			contact.points[1] = {overlapMax.x, contact.point.y};
+		}
+		contact.pointCount = 2;
 
 		return contact;
 	}
 
-	Contact collide(const Circle &a, const Circle &b)
+	namespace
 	{
-		glm::vec2 delta = a.center - b.center;
-		float distance = glm::length(delta);
-		float radiusSum = a.radius + b.radius;
+		glm::vec2 Perp(const glm::vec2 &axis)
+		{
+			return {-axis.y, axis.x};
+		}
 
-		if (distance <= 0.0f || distance >= radiusSum)
+		// Наибольшее разделение b от граней a. Прямоугольник симметричен, поэтому
+		// проверяются две оси a, а знак выбирает грань, смотрящую на b.
+		// faceNormal — наружная нормаль этой грани, faceAxis — 0 (ось X a) или 1 (ось Y).
+		float FaceSeparation(const Obb &a, const Obb &b, glm::vec2 &faceNormal, int &faceAxis)
 		{
+			const glm::vec2 ua = a.axis, va = Perp(a.axis);
+			const glm::vec2 ub = b.axis, vb = Perp(b.axis);
+			const glm::vec2 d = b.center - a.center;
+
+			const float du = glm::dot(ua, d);
+			const float dv = glm::dot(va, d);
+			const float radiusU = std::abs(glm::dot(ua, ub)) * b.halfSize.x + std::abs(glm::dot(ua, vb)) * b.halfSize.y;
+			const float radiusV = std::abs(glm::dot(va, ub)) * b.halfSize.x + std::abs(glm::dot(va, vb)) * b.halfSize.y;
+			const float separationU = std::abs(du) - a.halfSize.x - radiusU;
+			const float separationV = std::abs(dv) - a.halfSize.y - radiusV;
+
+			const bool useU = separationU >= separationV;
+			faceAxis = useU ? 0 : 1;
+			faceNormal = (useU ? ua : va) * ((useU ? du : dv) < 0.0f ? -1.0f : 1.0f);
+			return useU ? separationU : separationV;
+		}
+	}
+
+	Contact collide(const Obb &a, const Obb &b)
+	{
+		glm::vec2 normalA, normalB;
+		int axisA, axisB;
+		const float separationA = FaceSeparation(a, b, normalA, axisA);
+		if (separationA >= 0.0f)
 			return {};
+		const float separationB = FaceSeparation(b, a, normalB, axisB);
+		if (separationB >= 0.0f)
+			return {};
+
+		// Опорная грань — с меньшим проникновением. Грань a предпочитаем с допуском,
+		// чтобы при почти равных разделениях она не скакала между кадрами.
+		constexpr float k_faceTolerance = 1e-3f;
+		const bool flip = separationB > separationA + k_faceTolerance;
+		const Obb &reference = flip ? b : a;
+		const Obb &incident = flip ? a : b;
+		const glm::vec2 normal = flip ? normalB : normalA; // наружу от опорного к падающему
+		const int referenceAxis = flip ? axisB : axisA;
+
+		const glm::vec2 tangent = referenceAxis == 0 ? Perp(reference.axis) : reference.axis;
+		const float normalExtent = referenceAxis == 0 ? reference.halfSize.x : reference.halfSize.y;
+		const float tangentExtent = referenceAxis == 0 ? reference.halfSize.y : reference.halfSize.x;
+		const glm::vec2 faceCenter = reference.center + normal * normalExtent;
+
+		// Падающая грань — самая встречная к нормали опорной
+		const glm::vec2 incidentU = incident.axis, incidentV = Perp(incident.axis);
+		const float dotU = glm::dot(normal, incidentU);
+		const float dotV = glm::dot(normal, incidentV);
+		const bool useU = std::abs(dotU) >= std::abs(dotV);
+		const glm::vec2 incidentNormal = (useU ? incidentU : incidentV) * ((useU ? dotU : dotV) > 0.0f ? -1.0f : 1.0f);
+		const glm::vec2 incidentTangent = useU ? incidentV : incidentU;
+		const glm::vec2 edgeCenter = incident.center + incidentNormal * (useU ? incident.halfSize.x : incident.halfSize.y);
+		const glm::vec2 edgeHalf = incidentTangent * (useU ? incident.halfSize.y : incident.halfSize.x);
+
+		// Обрезаем ребро боковыми плоскостями опорной грани
+		glm::vec2 start = edgeCenter - edgeHalf;
+		glm::vec2 end = edgeCenter + edgeHalf;
+		float startT = glm::dot(tangent, start - faceCenter);
+		float endT = glm::dot(tangent, end - faceCenter);
+		if (startT > endT)
+		{
+			std::swap(start, end);
+			std::swap(startT, endT);
+		}
+
+		glm::vec2 clipped[2] = {start, end};
+		const float length = endT - startT;
+		if (length > 0.0f)
+		{
+			const float low = std::max(startT, -tangentExtent);
+			const float high = std::min(endT, tangentExtent);
+			clipped[0] = start + (end - start) * ((low - startT) / length);
+			clipped[1] = start + (end - start) * ((high - startT) / length);
+		}
+
+		Contact contact;
+		contact.intersecting = true;
+		// Нормаль контакта — от b к a
+		contact.normal = flip ? normal : -normal;
+
+		// Оставляем точки под опорной гранью; глубина — их наибольшее проникновение
+		for (const glm::vec2 &point : clipped)
+		{
+			const float separation = glm::dot(normal, point - faceCenter);
+			if (separation > 0.0f)
+				continue;
+			contact.points[contact.pointCount++] = point;
+			contact.penetration = std::max(contact.penetration, -separation);
 		}
 
+		if (contact.pointCount == 0)
+		{
+			// Касание на грани погрешности — берём глубину по оси
+			contact.penetration = -std::max(separationA, separationB);
+			contact.point = (a.center + b.center) * 0.5f;
+			return contact;
+		}
+
+		contact.point = contact.pointCount == 2 ? (contact.points[0] + contact.points[1]) * 0.5f : contact.points[0];
+		return contact;
+	}
+
+	Contact collide(const Circle &a, const Circle &b)
+	{
+		// Отсев по квадрату расстояния — корень только для пересекающихся
+		const glm::vec2 delta = a.center - b.center;
+		const float distanceSq = glm::dot(delta, delta);
+		const float radiusSum = a.radius + b.radius;
+		if (distanceSq >= radiusSum * radiusSum)
+			return {};
+
 		Contact c;
 		c.intersecting = true;
+
+		const float distance = std::sqrt(distanceSq);
 		c.penetration = radiusSum - distance;
-		c.normal = delta / distance; // нормализованный вектор от B к A
+		// Совпавшие центры — расталкиваем по любой оси
+		c.normal = distance > 0.0f ? delta / distance : glm::vec2(0.0f, 1.0f); // от B к A
+		c.point = b.center + c.normal * b.radius;
 		return c;
 	}
 
 	Contact collide(const Aabb &a, const Circle &b)
 	{
 		// Находим ближайшую точку AABB к центру круга
-		float closestX = std::clamp(b.center.x, a.center.x - a.halfSize.x, a.center.x + a.halfSize.x);
-		float closestY = std::clamp(b.center.y, a.center.y - a.halfSize.y, a.center.y + a.halfSize.y);
-
-		glm::vec2 closestPoint{closestX, closestY};
-		glm::vec2 delta = b.center - closestPoint;
-		float distance = glm::length(delta);
+		const glm::vec2 minA = a.center - a.halfSize;
+		const glm::vec2 maxA = a.center + a.halfSize;
+		const glm::vec2 closestPoint = glm::clamp(b.center, minA, maxA);
+		const glm::vec2 delta = b.center - closestPoint;
+		const float distanceSq = glm::dot(delta, delta);
 
-		if (distance <= 0.0f || distance >= b.radius)
-		{
+		if (distanceSq >= b.radius * b.radius)
 			return {};
-		}
 
 		Contact c;
 		c.intersecting = true;
-		c.penetration = b.radius - distance;
-		c.normal = (distance > 0.0f) ? (delta / distance) : glm::vec2(1.0f, 0.0f);
+
+		if (distanceSq > 0.0f)
+		{
+			const float distance = std::sqrt(distanceSq);
+			c.penetration = b.radius - distance;
+			c.normal = -delta / distance; // от круга к ящику
+			c.point = closestPoint;
+			return c;
+		}
+
+		// Центр круга внутри ящика — выталкиваем через ближайшую грань
+		const glm::vec2 local = b.center - a.center;
+		const glm::vec2 gap = a.halfSize - glm::abs(local);
+		if (gap.x < gap.y)
+		{
+			c.penetration = gap.x + b.radius;
+			c.normal = {local.x < 0.0f ? 1.0f : -1.0f, 0.0f};
+		}
+		else
+		{
+			c.penetration = gap.y + b.radius;
+			c.normal = {0.0f, local.y < 0.0f ? 1.0f : -1.0f};
+		}
+		c.point = b.center;
+		return c;
+	}
+
+	Contact collide(const Obb &a, const Circle &b)
+	{
+		// Круг переводим в оси ящика, результат — обратно в мир
+		const glm::vec2 axisX = a.axis, axisY = Perp(a.axis);
+		const glm::vec2 offset = b.center - a.center;
+		const glm::vec2 local(glm::dot(offset, axisX), glm::dot(offset, axisY));
+
+		Contact c = collide(Aabb{glm::vec2(0.0f), a.halfSize}, Circle{local, b.radius});
+		if (!c.intersecting)
+			return c;
+
+		c.normal = axisX * c.normal.x + axisY * c.normal.y;
+		c.point = a.center + axisX * c.point.x + axisY * c.point.y;
 		return c;
 	}
 } // namespace le
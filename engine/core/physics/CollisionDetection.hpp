@@ -15,8 +15,13 @@ namespace le
 
 	SweptResult sweptAABB(const Aabb &a, const glm::vec2 &velA, const Aabb &b, float dt);
 
+	// Нормаль контакта всегда направлена от b к a, penetration > 0
 	Contact collide(const Aabb &a, const Aabb &b);
+	// SAT по четырём осям граней; манифолд — падающее ребро, обрезанное по опорной грани
+	Contact collide(const Obb &a, const Obb &b);
 	Contact collide(const Circle &a, const Circle &b);
+	// Центр круга внутри ящика тоже даёт контакт — через ближайшую грань
 	Contact collide(const Aabb &a, const Circle &b);
+	Contact collide(const Obb &a, const Circle &b);
 
 } // namespace le
@@ -65,6 +65,81 @@ namespace le
 		}
 	}
 
+	// Касательная к нормали — фиксированное направление, чтобы импульс трения
+	// можно было накапливать между кадрами
+	static glm::vec2 contactTangent(const glm::vec2 &normal)
+	{
+		return glm::vec2(-normal.y, normal.x);
+	}
+
+	float contactVelocityBias(
+		const glm::vec2 &velA, const glm::vec2 &velB,
+		const glm::vec2 &normal,
+		float restitution)
+	{
+		const float k_restitutionThreshold = 20.0f; // пикс/с — медленнее не отскакиваем
+
+		float velAlongNormal = glm::dot(velA - velB, normal);
+		if (velAlongNormal < -k_restitutionThreshold)
+			return -restitution * velAlongNormal;
+
+		return 0.0f;
+	}
+
+	void warmStartContact(
+		glm::vec2 &velA, glm::vec2 &velB,
+		float invMassA, float invMassB,
+		const glm::vec2 &normal,
+		float normalImpulse,
+		float tangentImpulse)
+	{
+		glm::vec2 impulse = normal * normalImpulse + contactTangent(normal) * tangentImpulse;
+		velA += impulse * invMassA;
+		velB -= impulse * invMassB;
+	}
+
+	void solveContactVelocity(
+		glm::vec2 &velA, glm::vec2 &velB,
+		float invMassA, float invMassB,
+		const glm::vec2 &normal,
+		float velocityBias,
+		float friction,
+		float &normalImpulse,
+		float &tangentImpulse)
+	{
+		float invMassSum = invMassA + invMassB;
+		if (invMassSum == 0.0f)
+			return; // оба статические
+
+		// === Трение: сначала, пока предел считается по импульсу прошлой итерации ===
+		glm::vec2 tangent = contactTangent(normal);
+		float vt = glm::dot(velA - velB, tangent);
+		float jt = -vt / invMassSum;
+
+		// Закон Кулона для суммарного импульса: |Jt| <= friction * Jn
+		float maxFriction = friction * normalImpulse;
+		float newTangentImpulse = std::clamp(tangentImpulse + jt, -maxFriction, maxFriction);
+		jt = newTangentImpulse - tangentImpulse;
+		tangentImpulse = newTangentImpulse;
+
+		glm::vec2 frictionImpulse = tangent * jt;
+		velA += frictionImpulse * invMassA;
+		velB -= frictionImpulse * invMassB;
+
+		// === Нормальный импульс: целевая скорость разлёта = velocityBias ===
+		float vn = glm::dot(velA - velB, normal);
+		float j = (velocityBias - vn) / invMassSum;
+
+		// Суммарный импульс не может тянуть тела друг к другу
+		float newNormalImpulse = std::max(normalImpulse + j, 0.0f);
+		j = newNormalImpulse - normalImpulse;
+		normalImpulse = newNormalImpulse;
+
+		glm::vec2 impulse = normal * j;
+		velA += impulse * invMassA;
+		velB -= impulse * invMassB;
+	}
+
 	void resolvePosition(
 		glm::vec2 &posA, glm::vec2 &posB,
 		float invMassA, float invMassB,
@@ -36,6 +36,48 @@ namespace le
 		float friction,
 		float dt);
 
+	/**
+	 * @brief Скорость отскока для контакта (считается один раз до итераций солвера).
+	 *
+	 * @return целевая скорость разлёта вдоль нормали: -restitution * vn, если тела
+	 *         сближаются быстрее порога, иначе 0 (покоящиеся контакты не подпрыгивают)
+	 */
+	float contactVelocityBias(
+		const glm::vec2 &velA, const glm::vec2 &velB,
+		const glm::vec2 &normal,
+		float restitution);
+
+	/**
+	 * @brief Warm start — применяет накопленные импульсы прошлого кадра.
+	 *
+	 * @param normalImpulse, tangentImpulse — накопленные импульсы из ContactCache
+	 */
+	void warmStartContact(
+		glm::vec2 &velA, glm::vec2 &velB,
+		float invMassA, float invMassB,
+		const glm::vec2 &normal,
+		float normalImpulse,
+		float tangentImpulse);
+
+	/**
+	 * @brief Одна итерация sequential impulses с накоплением импульса (как в Box2D).
+	 *
+	 * В отличие от resolveVelocity, ограничение j >= 0 и конус трения применяются
+	 * к суммарному импульсу, поэтому решение можно переносить между кадрами.
+	 * Проникновение здесь не исправляется — это делает resolvePosition.
+	 *
+	 * @param velocityBias — результат contactVelocityBias
+	 * @param normalImpulse, tangentImpulse — накопленные импульсы (изменяются!)
+	 */
+	void solveContactVelocity(
+		glm::vec2 &velA, glm::vec2 &velB,
+		float invMassA, float invMassB,
+		const glm::vec2 &normal,
+		float velocityBias,
+		float friction,
+		float &normalImpulse,
+		float &tangentImpulse);
+
 	// Position resolver — изменяет позиции
 	void resolvePosition(
 		glm::vec2 &posA, glm::vec2 &posB,
@@ -1,5 +1,6 @@
 // engine/core/physics/CollisionShapes.hpp
 #pragma once
+#include <cstdint>
 #include <glm/vec2.hpp>
 
 namespace le
@@ -11,6 +12,14 @@ namespace le
 		glm::vec2 halfSize; // половина ширины и высоты (half-extents)
 	};
 
+	// Повёрнутый прямоугольник (OBB)
+	struct Obb
+	{
+		glm::vec2 center;
+		glm::vec2 halfSize; // в осях прямоугольника
+		glm::vec2 axis;		// (cos, sin) — его ось X в мире; ось Y = (-sin, cos)
+	};
+
 	struct Circle
 	{
 		glm::vec2 center; // центр круга
@@ -24,6 +33,10 @@ namespace le
 		float penetration = 0.0f;
 
 		glm::vec2 point;
+
+		// Манифолд ящик–ящик: точки на грани контакта (у круга — ни одной)
+		glm::vec2 points[2];
+		uint8_t pointCount = 0;
 	};
 
 } // namespace le
@@ -0,0 +1,105 @@
+// engine/core/physics/ContactCache.cpp
+#include "ContactCache.hpp"
+#include <algorithm>
+#include <glm/geometric.hpp>
+
+namespace le
+{
+
+	// Warm start только если нормаль почти не изменилась — иначе старый импульс вреден
+	static const float k_warmStartNormalDot = 0.95f;
+
+	void ContactCache::BeginStep(const uint64_t *keys, const glm::vec2 *normals, size_t count,
+								 float *normalImpulses, float *tangentImpulses,
+								 const RetainPredicate &retain)
+	{
+		m_keys.assign(keys, keys + count);
+		m_normals.assign(normals, normals + count);
+
+		m_order.resize(count);
+		for (size_t i = 0; i < count; ++i)
+			m_order[i] = static_cast<uint32_t>(i);
+
+		std::sort(m_order.begin(), m_order.end(), [&](uint32_t lhs, uint32_t rhs)
+				  { return m_keys[lhs] < m_keys[rhs]; });
+
+		m_began.clear();
+		m_ended.clear();
+		m_retained.clear();
+
+		// Запись прошлого кадра, которой нет в этом шаге
+		auto dropOrRetain = [&](const Entry &entry)
+		{
+			if (retain && retain(entry.key))
+				m_retained.push_back(entry);
+			else
+				m_ended.push_back(entry.key);
+		};
+
+		// Слияние двух отсортированных списков: прошлый кадр (m_entries) и текущий (m_order)
+		size_t e = 0;
+		for (uint32_t idx : m_order)
+		{
+			uint64_t key = m_keys[idx];
+
+			while (e < m_entries.size() && m_entries[e].key < key)
+				dropOrRetain(m_entries[e++]);
+
+			normalImpulses[idx] = 0.0f;
+			tangentImpulses[idx] = 0.0f;
+
+			if (e < m_entries.size() && m_entries[e].key == key)
+			{
+				const Entry &cached = m_entries[e++];
+				if (glm::dot(cached.normal, m_normals[idx]) > k_warmStartNormalDot)
+				{
+					normalImpulses[idx] = cached.normalImpulse;
+					tangentImpulses[idx] = cached.tangentImpulse;
+				}
+			}
+			else
+			{
+				m_began.push_back(key);
+			}
+		}
+
+		while (e < m_entries.size())
+			dropOrRetain(m_entries[e++]);
+	}
+
+	void ContactCache::EndStep(const float *normalImpulses, const float *tangentImpulses)
+	{
+		// Слияние контактов шага с сохранёнными — оба списка отсортированы по ключу
+		m_entries.clear();
+		m_entries.reserve(m_order.size() + m_retained.size());
+
+		size_t r = 0;
+		for (uint32_t idx : m_order)
+		{
+			while (r < m_retained.size() && m_retained[r].key < m_keys[idx])
+				m_entries.push_back(m_retained[r++]);
+
+			m_entries.push_back({m_keys[idx], m_normals[idx], normalImpulses[idx], tangentImpulses[idx]});
+		}
+		m_entries.insert(m_entries.end(), m_retained.begin() + r, m_retained.end());
+	}
+
+	void ContactCache::Clear()
+	{
+		m_entries.clear();
+		m_order.clear();
+		m_keys.clear();
+		m_normals.clear();
+		m_retained.clear();
+		m_began.clear();
+		m_ended.clear();
+	}
+
+	void ContactCache::Restore(const Entry *entries, size_t count)
+	{
+		m_entries.assign(entries, entries + count);
+		m_began.clear();
+		m_ended.clear();
+	}
+
+} // namespace le
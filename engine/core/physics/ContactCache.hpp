@@ -0,0 +1,83 @@
+// engine/core/physics/ContactCache.hpp
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <glm/vec2.hpp>
+
+#include <extern/entt/entt.hpp>
+
+namespace le
+{
+
+	/**
+	 * @brief Кэш контактов между кадрами.
+	 *
+	 * Хранит для каждой пары сущностей накопленные импульсы (нормальный и трения),
+	 * чтобы солвер стартовал с решения прошлого кадра (warm starting).
+	 * Записи лежат отсортированными по ключу пары, поэтому сопоставление с новым
+	 * кадром — один линейный проход, а заодно даёт списки начавшихся и закончившихся контактов.
+	 */
+	class ContactCache
+	{
+	public:
+		struct Entry
+		{
+			uint64_t key;
+			glm::vec2 normal;
+			float normalImpulse;
+			float tangentImpulse;
+		};
+
+		// Ключ пары не зависит от порядка сущностей
+		static uint64_t MakeKey(entt::entity a, entt::entity b)
+		{
+			uint64_t ia = static_cast<uint64_t>(entt::to_integral(a));
+			uint64_t ib = static_cast<uint64_t>(entt::to_integral(b));
+			return ia < ib ? (ia << 32) | ib : (ib << 32) | ia;
+		}
+
+		static entt::entity KeyFirst(uint64_t key) { return static_cast<entt::entity>(static_cast<uint32_t>(key >> 32)); }
+		static entt::entity KeySecond(uint64_t key) { return static_cast<entt::entity>(static_cast<uint32_t>(key)); }
+
+		/**
+		 * @brief Сопоставляет контакты текущего шага с кэшем.
+		 *
+		 * @param keys — ключи контактов шага (каждая пара один раз, порядок любой)
+		 * @param normals — нормали контактов
+		 * @param normalImpulses, tangentImpulses — [out] импульсы для warm start
+		 *        (0, если пара новая или нормаль заметно повернулась)
+		 * @param retain — для пар прошлого кадра, которых нет в этом шаге: true — пара
+		 *        не закончилась, а просто не проверялась (спящие тела), запись сохраняется
+		 */
+		using RetainPredicate = std::function<bool(uint64_t key)>;
+		void BeginStep(const uint64_t *keys, const glm::vec2 *normals, size_t count,
+					   float *normalImpulses, float *tangentImpulses,
+					   const RetainPredicate &retain = nullptr);
+
+		// Сохраняет итоговые импульсы шага. Порядок массивов тот же, что в BeginStep.
+		void EndStep(const float *normalImpulses, const float *tangentImpulses);
+
+		void Clear();
+		// Заменяет записи кэша (снимок для отката); entries отсортированы по key.
+		// Списки начавшихся / закончившихся контактов сбрасываются.
+		void Restore(const Entry *entries, size_t count);
+
+		// Пары, которые начали / перестали касаться в последнем шаге
+		const std::vector<uint64_t> &Began() const { return m_began; }
+		const std::vector<uint64_t> &Ended() const { return m_ended; }
+
+		const std::vector<Entry> &Entries() const { return m_entries; }
+		size_t Size() const { return m_entries.size(); }
+
+	private:
+		std::vector<Entry> m_entries;	 // отсортированы по key
+		std::vector<uint32_t> m_order;	 // индексы контактов шага, отсортированные по ключу
+		std::vector<uint64_t> m_keys;	 // ключи контактов шага
+		std::vector<glm::vec2> m_normals; // нормали контактов шага
+		std::vector<Entry> m_retained;	  // сохранённые без проверки (отсортированы по key)
+		std::vector<uint64_t> m_began;
+		std::vector<uint64_t> m_ended;
+	};
+
+} // namespace le
@@ -0,0 +1,325 @@
+// engine/core/physics/DynamicAabbTree.cpp
+#include "DynamicAabbTree.hpp"
+
+#include <algorithm>
+
+namespace le
+{
+
+	namespace
+	{
+		float Perimeter(const glm::vec2 &minCorner, const glm::vec2 &maxCorner)
+		{
+			return 2.0f * ((maxCorner.x - minCorner.x) + (maxCorner.y - minCorner.y));
+		}
+
+		bool Contains(const glm::vec2 &outerMin, const glm::vec2 &outerMax,
+					  const glm::vec2 &innerMin, const glm::vec2 &innerMax)
+		{
+			return outerMin.x <= innerMin.x && outerMin.y <= innerMin.y &&
+				   innerMax.x <= outerMax.x && innerMax.y <= outerMax.y;
+		}
+	}
+
+	int32_t DynamicAabbTree::AllocateNode()
+	{
+		if (m_freeList == k_nullNode)
+		{
+			m_nodes.emplace_back();
+			m_nodes.back().height = 0;
+			return static_cast<int32_t>(m_nodes.size() - 1);
+		}
+
+		int32_t node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+		m_nodes[node] = Node{};
+		m_nodes[node].height = 0;
+		return node;
+	}
+
+	void DynamicAabbTree::FreeNode(int32_t node)
+	{
+		m_nodes[node].parent = m_freeList;
+		m_nodes[node].height = -1;
+		m_freeList = node;
+	}
+
+	int32_t DynamicAabbTree::CreateProxy(const glm::vec2 &minCorner, const glm::vec2 &maxCorner, uint32_t userData)
+	{
+		int32_t proxy = AllocateNode();
+		Node &node = m_nodes[proxy];
+		node.minCorner = minCorner - glm::vec2(m_margin);
+		node.maxCorner = maxCorner + glm::vec2(m_margin);
+		node.userData = userData;
+
+		InsertLeaf(proxy);
+		++m_proxyCount;
+		return proxy;
+	}
+
+	void DynamicAabbTree::DestroyProxy(int32_t proxy)
+	{
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		--m_proxyCount;
+	}
+
+	bool DynamicAabbTree::MoveProxy(int32_t proxy, const glm::vec2 &minCorner, const glm::vec2 &maxCorner)
+	{
+		Node &node = m_nodes[proxy];
+
+		// Толстые границы, раздутые быстрым движением, тоже обновляем — иначе
+		// остановившееся тело так и собирало бы лишние пары
+		const glm::vec2 limit(4.0f * m_margin);
+		if (Contains(node.minCorner, node.maxCorner, minCorner, maxCorner) &&
+			Contains(minCorner - limit, maxCorner + limit, node.minCorner, node.maxCorner))
+			return false;
+
+		RemoveLeaf(proxy);
+		m_nodes[proxy].minCorner = minCorner - glm::vec2(m_margin);
+		m_nodes[proxy].maxCorner = maxCorner + glm::vec2(m_margin);
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	void DynamicAabbTree::Clear()
+	{
+		m_nodes.clear();
+		m_root = k_nullNode;
+		m_freeList = k_nullNode;
+		m_proxyCount = 0;
+	}
+
+	void DynamicAabbTree::InsertLeaf(int32_t leaf)
+	{
+		if (m_root == k_nullNode)
+		{
+			m_root = leaf;
+			m_nodes[leaf].parent = k_nullNode;
+			return;
+		}
+
+		const glm::vec2 leafMin = m_nodes[leaf].minCorner;
+		const glm::vec2 leafMax = m_nodes[leaf].maxCorner;
+
+		// Спускаемся туда, где прирост суммарного периметра меньше
+		int32_t index = m_root;
+		while (!m_nodes[index].IsLeaf())
+		{
+			const Node &node = m_nodes[index];
+			const int32_t child1 = node.child1;
+			const int32_t child2 = node.child2;
+
+			float area = Perimeter(node.minCorner, node.maxCorner);
+			float combinedArea = Perimeter(glm::min(node.minCorner, leafMin), glm::max(node.maxCorner, leafMax));
+
+			// Стоимость сделать лист соседом этого узла
+			float cost = 2.0f * combinedArea;
+			// Прирост, который достанется всем предкам при спуске ниже
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto descendCost = [&](int32_t child)
+			{
+				const Node &c = m_nodes[child];
+				float enlarged = Perimeter(glm::min(c.minCorner, leafMin), glm::max(c.maxCorner, leafMax));
+				if (c.IsLeaf())
+					return enlarged + inheritanceCost;
+				return enlarged - Perimeter(c.minCorner, c.maxCorner) + inheritanceCost;
+			};
+
+			float cost1 = descendCost(child1);
+			float cost2 = descendCost(child2);
+
+			if (cost < cost1 && cost < cost2)
+				break;
+
+			index = cost1 < cost2 ? child1 : child2;
+		}
+
+		const int32_t sibling = index;
+		const int32_t oldParent = m_nodes[sibling].parent;
+
+		// AllocateNode может переложить m_nodes — ссылки берём после
+		const int32_t newParent = AllocateNode();
+		Node &parent = m_nodes[newParent];
+		parent.parent = oldParent;
+		parent.minCorner = glm::min(leafMin, m_nodes[sibling].minCorner);
+		parent.maxCorner = glm::max(leafMax, m_nodes[sibling].maxCorner);
+		parent.height = m_nodes[sibling].height + 1;
+		parent.child1 = sibling;
+		parent.child2 = leaf;
+
+		if (oldParent != k_nullNode)
+		{
+			if (m_nodes[oldParent].child1 == sibling)
+				m_nodes[oldParent].child1 = newParent;
+			else
+				m_nodes[oldParent].child2 = newParent;
+		}
+		else
+		{
+			m_root = newParent;
+		}
+
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+
+		FixUpwards(m_nodes[leaf].parent);
+	}
+
+	void DynamicAabbTree::RemoveLeaf(int32_t leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = k_nullNode;
+			return;
+		}
+
+		const int32_t parent = m_nodes[leaf].parent;
+		const int32_t grandParent = m_nodes[parent].parent;
+		const int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+		// Родитель листа исчезает, его место занимает сосед
+		if (grandParent != k_nullNode)
+		{
+			if (m_nodes[grandParent].child1 == parent)
+				m_nodes[grandParent].child1 = sibling;
+			else
+				m_nodes[grandParent].child2 = sibling;
+
+			m_nodes[sibling].parent = grandParent;
+			FreeNode(parent);
+			FixUpwards(grandParent);
+		}
+		else
+		{
+			m_root = sibling;
+			m_nodes[sibling].parent = k_nullNode;
+			FreeNode(parent);
+		}
+	}
+
+	void DynamicAabbTree::FixUpwards(int32_t index)
+	{
+		while (index != k_nullNode)
+		{
+			index = Balance(index);
+
+			Node &node = m_nodes[index];
+			const Node &child1 = m_nodes[node.child1];
+			const Node &child2 = m_nodes[node.child2];
+
+			node.height = 1 + std::max(child1.height, child2.height);
+			node.minCorner = glm::min(child1.minCorner, child2.minCorner);
+			node.maxCorner = glm::max(child1.maxCorner, child2.maxCorner);
+
+			index = node.parent;
+		}
+	}
+
+	int32_t DynamicAabbTree::Balance(int32_t iA)
+	{
+		Node &a = m_nodes[iA];
+		if (a.IsLeaf() || a.height < 2)
+			return iA;
+
+		const int32_t iB = a.child1;
+		const int32_t iC = a.child2;
+		Node &b = m_nodes[iB];
+		Node &c = m_nodes[iC];
+
+		const int32_t balance = c.height - b.height;
+
+		// Правое поддерево выше — поднимаем C
+		if (balance > 1)
+		{
+			const int32_t iF = c.child1;
+			const int32_t iG = c.child2;
+			Node &f = m_nodes[iF];
+			Node &g = m_nodes[iG];
+
+			c.child1 = iA;
+			c.parent = a.parent;
+			a.parent = iC;
+
+			if (c.parent != k_nullNode)
+			{
+				if (m_nodes[c.parent].child1 == iA)
+					m_nodes[c.parent].child1 = iC;
+				else
+					m_nodes[c.parent].child2 = iC;
+			}
+			else
+			{
+				m_root = iC;
+			}
+
+			// Более высокий внук остаётся под C, другой переходит к A
+			const int32_t iHigh = f.height > g.height ? iF : iG;
+			const int32_t iLow = f.height > g.height ? iG : iF;
+			Node &high = m_nodes[iHigh];
+			Node &low = m_nodes[iLow];
+
+			c.child2 = iHigh;
+			a.child2 = iLow;
+			low.parent = iA;
+
+			a.minCorner = glm::min(b.minCorner, low.minCorner);
+			a.maxCorner = glm::max(b.maxCorner, low.maxCorner);
+			c.minCorner = glm::min(a.minCorner, high.minCorner);
+			c.maxCorner = glm::max(a.maxCorner, high.maxCorner);
+
+			a.height = 1 + std::max(b.height, low.height);
+			c.height = 1 + std::max(a.height, high.height);
+
+			return iC;
+		}
+
+		// Левое поддерево выше — поднимаем B
+		if (balance < -1)
+		{
+			const int32_t iD = b.child1;
+			const int32_t iE = b.child2;
+			Node &d = m_nodes[iD];
+			Node &e = m_nodes[iE];
+
+			b.child1 = iA;
+			b.parent = a.parent;
+			a.parent = iB;
+
+			if (b.parent != k_nullNode)
+			{
+				if (m_nodes[b.parent].child1 == iA)
+					m_nodes[b.parent].child1 = iB;
+				else
+					m_nodes[b.parent].child2 = iB;
+			}
+			else
+			{
+				m_root = iB;
+			}
+
+			const int32_t iHigh = d.height > e.height ? iD : iE;
+			const int32_t iLow = d.height > e.height ? iE : iD;
+			Node &high = m_nodes[iHigh];
+			Node &low = m_nodes[iLow];
+
+			b.child2 = iHigh;
+			a.child1 = iLow;
+			low.parent = iA;
+
+			a.minCorner = glm::min(c.minCorner, low.minCorner);
+			a.maxCorner = glm::max(c.maxCorner, low.maxCorner);
+			b.minCorner = glm::min(a.minCorner, high.minCorner);
+			b.maxCorner = glm::max(a.maxCorner, high.maxCorner);
+
+			a.height = 1 + std::max(c.height, low.height);
+			b.height = 1 + std::max(a.height, high.height);
+
+			return iB;
+		}
+
+		return iA;
+	}
+
+} // namespace le
@@ -0,0 +1,108 @@
+// engine/core/physics/DynamicAabbTree.hpp
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+
+namespace le
+{
+
+	/**
+	 * @brief Динамическое дерево AABB (BVH) с "толстыми" границами.
+	 *
+	 * Листья хранят границы прокси, расширенные на margin. Пока настоящие границы
+	 * лежат внутри толстых, MoveProxy ничего не делает — дерево не трогается.
+	 * Вставка выбирает соседа по приросту периметра, после вставки и удаления
+	 * путь до корня балансируется поворотами, так что высота остаётся ~log n.
+	 *
+	 * Query только читает дерево — его можно вызывать из нескольких потоков сразу.
+	 */
+	class DynamicAabbTree
+	{
+	public:
+		static constexpr int32_t k_nullNode = -1;
+
+		explicit DynamicAabbTree(float margin = 8.0f) : m_margin(margin) {}
+
+		// Возвращает id прокси; userData отдаётся в Query
+		int32_t CreateProxy(const glm::vec2 &minCorner, const glm::vec2 &maxCorner, uint32_t userData);
+		void DestroyProxy(int32_t proxy);
+		// Переставляет лист, только если границы вышли из толстых (или те стали слишком велики).
+		// Возвращает true, если дерево изменилось.
+		bool MoveProxy(int32_t proxy, const glm::vec2 &minCorner, const glm::vec2 &maxCorner);
+		void Clear();
+
+		uint32_t GetUserData(int32_t proxy) const { return m_nodes[proxy].userData; }
+		const glm::vec2 &GetFatMin(int32_t proxy) const { return m_nodes[proxy].minCorner; }
+		const glm::vec2 &GetFatMax(int32_t proxy) const { return m_nodes[proxy].maxCorner; }
+
+		size_t ProxyCount() const { return m_proxyCount; }
+		int32_t Height() const { return m_root == k_nullNode ? 0 : m_nodes[m_root].height; }
+		float GetMargin() const { return m_margin; }
+
+		// callback(userData) для каждого листа, чьи толстые границы пересекают [minCorner, maxCorner]
+		// (касание считается)
+		template <typename Callback>
+		void Query(const glm::vec2 &minCorner, const glm::vec2 &maxCorner, Callback &&callback) const
+		{
+			if (m_root == k_nullNode)
+				return;
+
+			// Стек свой у каждого потока — после первого кадра память не выделяется
+			thread_local std::vector<int32_t> stack;
+			stack.clear();
+			stack.push_back(m_root);
+
+			while (!stack.empty())
+			{
+				const Node &node = m_nodes[stack.back()];
+				stack.pop_back();
+
+				if (node.maxCorner.x < minCorner.x || node.minCorner.x > maxCorner.x ||
+					node.maxCorner.y < minCorner.y || node.minCorner.y > maxCorner.y)
+					continue;
+
+				if (node.IsLeaf())
+				{
+					callback(node.userData);
+					continue;
+				}
+
+				stack.push_back(node.child1);
+				stack.push_back(node.child2);
+			}
+		}
+
+	private:
+		struct Node
+		{
+			glm::vec2 minCorner;
+			glm::vec2 maxCorner;
+			int32_t parent = k_nullNode; // у свободного узла — следующий свободный
+			int32_t child1 = k_nullNode;
+			int32_t child2 = k_nullNode;
+			int32_t height = -1; // 0 — лист, -1 — свободный узел
+			uint32_t userData = 0;
+
+			bool IsLeaf() const { return child1 == k_nullNode; }
+		};
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t node);
+
+		void InsertLeaf(int32_t leaf);
+		void RemoveLeaf(int32_t leaf);
+		// Поворот вокруг узла, если высоты его детей отличаются больше чем на 1.
+		// Возвращает узел, занявший место node.
+		int32_t Balance(int32_t node);
+		// Пересчитывает высоты и границы от node до корня, балансируя по пути
+		void FixUpwards(int32_t node);
+
+		std::vector<Node> m_nodes;
+		int32_t m_root = k_nullNode;
+		int32_t m_freeList = k_nullNode;
+		size_t m_proxyCount = 0;
+		float m_margin;
+	};
+
+} // namespace le
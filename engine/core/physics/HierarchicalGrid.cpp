@@ -0,0 +1,145 @@
+// engine/core/physics/HierarchicalGrid.cpp
+#include "HierarchicalGrid.hpp"
+
+#include <glm/common.hpp>
+
+namespace le
+{
+
+	void HierarchicalGrid::Clear()
+	{
+		// clear() сохраняет capacity — следующий кадр ничего не выделяет
+		m_items.clear();
+		m_ids.clear();
+		for (Level &level : m_levels)
+		{
+			level.items.clear();
+			level.boxes.clear();
+			level.ids.clear();
+			level.cellStart.assign(1, 0);
+			level.cols = 0;
+			level.rows = 0;
+		}
+		m_topLevel = -1;
+	}
+
+	void HierarchicalGrid::Insert(uint32_t id, const glm::vec2 &minCorner, const glm::vec2 &maxCorner)
+	{
+		// Наименьший уровень, чья ячейка вмещает наибольшую сторону объекта
+		const float extent = std::max(maxCorner.x - minCorner.x, maxCorner.y - minCorner.y);
+		int level = 0;
+		float cellSize = m_baseCellSize;
+		while (cellSize < extent && level < k_maxLevels - 1)
+		{
+			cellSize *= 2.0f;
+			++level;
+		}
+
+		m_levels[level].items.push_back(static_cast<uint32_t>(m_items.size()));
+		m_items.push_back({minCorner, maxCorner});
+		m_ids.push_back(id);
+		m_topLevel = std::max(m_topLevel, level);
+	}
+
+	void HierarchicalGrid::Build()
+	{
+		float cellSize = m_baseCellSize;
+		size_t first = 0;
+		for (int level = 0; level <= m_topLevel; ++level, cellSize *= 2.0f)
+		{
+			m_levels[level].first = first;
+			BuildLevel(m_levels[level], cellSize);
+			first += m_levels[level].boxes.size();
+		}
+	}
+
+	size_t HierarchicalGrid::UsedLevelCount() const
+	{
+		size_t count = 0;
+		for (int level = 0; level <= m_topLevel; ++level)
+			count += !m_levels[level].items.empty();
+		return count;
+	}
+
+	void HierarchicalGrid::BuildLevel(Level &level, float cellSize)
+	{
+		level.boxes.clear();
+		level.ids.clear();
+		if (level.items.empty())
+		{
+			level.cellStart.assign(1, 0);
+			level.cols = 0;
+			level.rows = 0;
+			return;
+		}
+
+		// === 1. Ячейка не меньше объектов уровня ===
+		// На верхнем уровне могут оказаться объекты крупнее его ячейки
+		glm::vec2 minCorner = m_items[level.items[0]].minCorner;
+		glm::vec2 maxCorner = minCorner;
+		float extent = 0.0f;
+		for (uint32_t index : level.items)
+		{
+			const Box &item = m_items[index];
+			minCorner = glm::min(minCorner, item.minCorner);
+			maxCorner = glm::max(maxCorner, item.minCorner);
+			extent = std::max(extent, std::max(item.maxCorner.x - item.minCorner.x, item.maxCorner.y - item.minCorner.y));
+		}
+		while (cellSize < extent)
+			cellSize *= 2.0f;
+
+		// === 2. Ограничиваем число ячеек ===
+		// Одиночный объект далеко от остальных не должен раздувать уровень: укрупняем
+		// ячейки вдвое, пока они не поместятся в лимит. Запросы остаются корректными.
+		const int64_t maxCells = std::max<int64_t>(k_minLevelCells, static_cast<int64_t>(level.items.size()) * k_levelCellsPerItem);
+		auto cellCount = [&](float size)
+		{
+			const int64_t cols = static_cast<int64_t>(std::floor(maxCorner.x / size)) - static_cast<int64_t>(std::floor(minCorner.x / size)) + 1;
+			const int64_t rows = static_cast<int64_t>(std::floor(maxCorner.y / size)) - static_cast<int64_t>(std::floor(minCorner.y / size)) + 1;
+			return cols * rows;
+		};
+		while (cellCount(cellSize) > maxCells)
+			cellSize *= 2.0f;
+
+		level.cellSize = cellSize;
+		level.extent = extent;
+		level.inverseCellSize = 1.0f / cellSize;
+		level.originX = static_cast<int>(std::floor(minCorner.x * level.inverseCellSize));
+		level.originY = static_cast<int>(std::floor(minCorner.y * level.inverseCellSize));
+		level.cols = static_cast<int>(std::floor(maxCorner.x * level.inverseCellSize)) - level.originX + 1;
+		level.rows = static_cast<int>(std::floor(maxCorner.y * level.inverseCellSize)) - level.originY + 1;
+
+		// === 3. Counting sort: каждый объект — ровно в одной ячейке ===
+		const size_t cells = static_cast<size_t>(level.cols) * static_cast<size_t>(level.rows);
+		level.cellStart.assign(cells + 1, 0);
+
+		auto cellOf = [&](const Box &item)
+		{
+			return static_cast<size_t>(level.CellY(item.minCorner.y)) * level.cols + level.CellX(item.minCorner.x);
+		};
+
+		for (uint32_t index : level.items)
+			++level.cellStart[cellOf(m_items[index])];
+
+		uint32_t running = 0;
+		for (size_t c = 0; c < cells; ++c)
+		{
+			running += level.cellStart[c];
+			level.cellStart[c] = running;
+		}
+		level.cellStart[cells] = running;
+
+		// С конца и с уменьшением курсора — внутри ячейки объекты в порядке вставки.
+		// Копии AABB лежат по ячейкам подряд: соседи читаются без прыжков по памяти.
+		level.boxes.resize(running);
+		level.ids.resize(running);
+		for (size_t k = level.items.size(); k-- > 0;)
+		{
+			const uint32_t index = level.items[k];
+			const uint32_t slot = --level.cellStart[cellOf(m_items[index])];
+			level.boxes[slot] = m_items[index];
+			level.ids[slot] = m_ids[index];
+		}
+	}
+
+} // namespace le
@@ -0,0 +1,154 @@
+// engine/core/physics/HierarchicalGrid.hpp
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glm/vec2.hpp>
+
+namespace le
+{
+
+	/**
+	 * @brief Иерархическая сетка для объектов разного размера.
+	 *
+	 * Уровень L — сетка с ячейкой baseCellSize * 2^L. Объект кладётся в один уровень,
+	 * чья ячейка не меньше его наибольшей стороны, и в одну ячейку — ту, где лежит
+	 * его левый верхний угол. Вставка O(1), а босс в 2000px не раскладывается по сотне
+	 * мелких ячеек и не раздувает списки соседей.
+	 *
+	 * Пары ищет каждый объект: в своём уровне и во всех более крупных (объекты мельче
+	 * найдут его сами). Углы соседей лежат в [min - extent, max], где extent — наибольшая
+	 * сторона объектов уровня, то есть в 1–3 ячейках по каждой оси. Внутри уровня ячейки
+	 * лежат плоско (counting sort, как в SpatialHashGrid::Mode::Flat), а объекты обходятся
+	 * по ячейкам — после "прогрева" память не выделяется.
+	 *
+	 * Кадр: Clear → Insert для всех объектов → Build → ForEachPair.
+	 */
+	class HierarchicalGrid
+	{
+	public:
+		static constexpr int k_maxLevels = 16;
+
+		explicit HierarchicalGrid(float baseCellSize = 100.0f) : m_baseCellSize(baseCellSize) {}
+
+		void Clear();
+		void Insert(uint32_t id, const glm::vec2 &minCorner, const glm::vec2 &maxCorner);
+		void Build();
+
+		size_t ItemCount() const { return m_items.size(); }
+		// Число уровней, в которых есть объекты (после Build())
+		size_t UsedLevelCount() const;
+		float GetBaseCellSize() const { return m_baseCellSize; }
+
+		// Все пары с пересекающимися AABB (касание считается), каждая один раз.
+		// callback(a, b): a < b.
+		template <typename Callback>
+		void ForEachPair(Callback &&callback) const
+		{
+			ForEachPairInRange(0, ItemCount(), std::forward<Callback>(callback));
+		}
+
+		// Пары, которые находят объекты [begin, end) в порядке обхода: уровень за уровнем,
+		// внутри уровня — по ячейкам. Сетка только читается — непересекающиеся диапазоны
+		// можно обходить из нескольких потоков.
+		template <typename Callback>
+		void ForEachPairInRange(size_t begin, size_t end, Callback &&callback) const
+		{
+			end = std::min(end, m_items.size());
+
+			int levelA = 0;
+			for (size_t k = begin; k < end; ++k)
+			{
+				while (k >= m_levels[levelA].first + m_levels[levelA].boxes.size())
+					++levelA;
+
+				const uint32_t own = static_cast<uint32_t>(k - m_levels[levelA].first);
+				const Box &a = m_levels[levelA].boxes[own];
+				const uint32_t idA = m_levels[levelA].ids[own];
+
+				for (int level = levelA; level <= m_topLevel; ++level)
+				{
+					const Level &grid = m_levels[level];
+					if (grid.cols == 0)
+						continue;
+
+					// Угол соседа лежит в [a.min - extent, a.max]
+					const int x0 = std::max(grid.CellX(a.minCorner.x - grid.extent), 0);
+					const int y0 = std::max(grid.CellY(a.minCorner.y - grid.extent), 0);
+					const int x1 = std::min(grid.CellX(a.maxCorner.x), grid.cols - 1);
+					const int y1 = std::min(grid.CellY(a.maxCorner.y), grid.rows - 1);
+					// Объект целиком за пределами уровня (уровень строится по своим объектам)
+					if (x0 > x1 || y0 > y1)
+						continue;
+
+					for (int y = y0; y <= y1; ++y)
+					{
+						// Ячейки строки лежат подряд — обходим их одним отрезком
+						const size_t row = static_cast<size_t>(y) * grid.cols;
+						uint32_t c = grid.cellStart[row + x0];
+						const uint32_t last = grid.cellStart[row + x1 + 1];
+						// Пару внутри уровня сообщает объект, который идёт раньше
+						if (level == levelA)
+							c = std::max(c, own + 1);
+
+						for (; c < last; ++c)
+						{
+							const Box &b = grid.boxes[c];
+							if (a.maxCorner.x < b.minCorner.x || a.minCorner.x > b.maxCorner.x ||
+								a.maxCorner.y < b.minCorner.y || a.minCorner.y > b.maxCorner.y)
+								continue;
+
+							const uint32_t idB = grid.ids[c];
+							callback(static_cast<size_t>(std::min(idA, idB)), static_cast<size_t>(std::max(idA, idB)));
+						}
+					}
+				}
+			}
+		}
+
+	private:
+		// std::floor без SSE4.1 — вызов функции, а ячейки считаются на каждый объект и уровень
+		static int FloorToInt(float value)
+		{
+			const int truncated = static_cast<int>(value);
+			return truncated - (static_cast<float>(truncated) > value);
+		}
+
+		struct Box
+		{
+			glm::vec2 minCorner;
+			glm::vec2 maxCorner;
+		};
+
+		struct Level
+		{
+			float cellSize = 0.0f; // baseCellSize * 2^level, укрупнённая в Build() при необходимости
+			float inverseCellSize = 0.0f;
+			float extent = 0.0f; // наибольшая сторона объекта уровня (не больше ячейки)
+			int originX = 0, originY = 0;
+			int cols = 0, rows = 0;
+			std::vector<uint32_t> items;		// объекты уровня — номера в m_items
+			std::vector<uint32_t> cellStart{0}; // начало каждой ячейки в boxes (+ конец)
+			std::vector<Box> boxes;				// AABB объектов уровня, сгруппированные по ячейкам
+			std::vector<uint32_t> ids;			// их id
+			size_t first = 0;					// номер первого объекта уровня в порядке обхода
+
+			int CellX(float x) const { return FloorToInt(x * inverseCellSize) - originX; }
+			int CellY(float y) const { return FloorToInt(y * inverseCellSize) - originY; }
+		};
+
+		void BuildLevel(Level &level, float cellSize);
+
+		static constexpr int64_t k_minLevelCells = 256;	  // нижняя граница лимита ячеек уровня
+		static constexpr int64_t k_levelCellsPerItem = 16; // лимит ячеек уровня на один объект
+
+		float m_baseCellSize;
+		std::vector<Box> m_items; // объекты этого кадра в порядке Insert
+		std::vector<uint32_t> m_ids;
+		Level m_levels[k_maxLevels];
+		int m_topLevel = -1; // самый крупный непустой уровень
+	};
+
+} // namespace le
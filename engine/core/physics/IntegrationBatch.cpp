@@ -0,0 +1,138 @@
+// engine/core/physics/IntegrationBatch.cpp
+#include "IntegrationBatch.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LE_INTEGRATION_X86 1
+#include <immintrin.h>
+#endif
+
+namespace le
+{
+
+	// Ядра читают vec2 как два float подряд
+	static_assert(sizeof(glm::vec2) == 2 * sizeof(float), "glm::vec2 must be two packed floats");
+
+	static void integrateScalar(glm::vec2 *positions, glm::vec2 *velocities, glm::vec2 *accelerations,
+								const uint8_t *flags, uint8_t *changed, size_t begin, size_t count,
+								uint8_t flagMask, uint8_t flagValue, float dt)
+	{
+		for (size_t k = begin; k < count; ++k)
+		{
+			if ((flags[k] & flagMask) != flagValue)
+				continue;
+
+			velocities[k] += accelerations[k] * dt;
+			positions[k] += velocities[k] * dt;
+			accelerations[k] = glm::vec2(0.0f);
+			changed[k] = 1;
+		}
+	}
+
+#ifdef LE_INTEGRATION_X86
+
+	// Два тела — четыре float: маска тела занимает обе его дорожки (x и y)
+	static size_t integrateSSE(float *positions, float *velocities, float *accelerations,
+							   const uint8_t *flags, uint8_t *changed, size_t begin, size_t count,
+							   uint8_t flagMask, uint8_t flagValue, float dt)
+	{
+		const __m128 step = _mm_set1_ps(dt);
+
+		size_t k = begin;
+		for (; k + 2 <= count; k += 2)
+		{
+			const int first = (flags[k] & flagMask) == flagValue ? -1 : 0;
+			const int second = (flags[k + 1] & flagMask) == flagValue ? -1 : 0;
+			const __m128 mask = _mm_castsi128_ps(_mm_set_epi32(second, second, first, first));
+
+			float *p = positions + 2 * k;
+			float *v = velocities + 2 * k;
+			float *a = accelerations + 2 * k;
+
+			const __m128 acceleration = _mm_loadu_ps(a);
+			const __m128 velocity = _mm_loadu_ps(v);
+			const __m128 position = _mm_loadu_ps(p);
+
+			const __m128 newVelocity = _mm_add_ps(velocity, _mm_mul_ps(acceleration, step));
+			const __m128 newPosition = _mm_add_ps(position, _mm_mul_ps(newVelocity, step));
+
+			_mm_storeu_ps(v, _mm_or_ps(_mm_and_ps(mask, newVelocity), _mm_andnot_ps(mask, velocity)));
+			_mm_storeu_ps(p, _mm_or_ps(_mm_and_ps(mask, newPosition), _mm_andnot_ps(mask, position)));
+			_mm_storeu_ps(a, _mm_andnot_ps(mask, acceleration)); // ноль там, где тело интегрировано
+
+			changed[k] |= static_cast<uint8_t>(first & 1);
+			changed[k + 1] |= static_cast<uint8_t>(second & 1);
+		}
+
+		return k;
+	}
+
+	// Четыре тела — восемь float. Флаги четырёх тел сравниваются одной инструкцией,
+	// байт результата расширяется на 64 бита — обе дорожки тела.
+	__attribute__((target("avx2"))) static size_t integrateAVX2(float *positions, float *velocities, float *accelerations,
+																 const uint8_t *flags, uint8_t *changed, size_t begin, size_t count,
+																 uint8_t flagMask, uint8_t flagValue, float dt)
+	{
+		const __m256 step = _mm256_set1_ps(dt);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m128i maskBytes = _mm_set1_epi8(static_cast<char>(flagMask));
+		const __m128i valueBytes = _mm_set1_epi8(static_cast<char>(flagValue));
+		const __m128i ones = _mm_set1_epi8(1);
+
+		size_t k = begin;
+		for (; k + 4 <= count; k += 4)
+		{
+			int32_t packed;
+			std::memcpy(&packed, flags + k, sizeof(packed));
+			const __m128i selected = _mm_cmpeq_epi8(_mm_and_si128(_mm_cvtsi32_si128(packed), maskBytes), valueBytes);
+			const __m256 mask = _mm256_castsi256_ps(_mm256_cvtepi8_epi64(selected));
+
+			float *p = positions + 2 * k;
+			float *v = velocities + 2 * k;
+			float *a = accelerations + 2 * k;
+
+			const __m256 acceleration = _mm256_loadu_ps(a);
+			const __m256 velocity = _mm256_loadu_ps(v);
+			const __m256 position = _mm256_loadu_ps(p);
+
+			const __m256 newVelocity = _mm256_add_ps(velocity, _mm256_mul_ps(acceleration, step));
+			const __m256 newPosition = _mm256_add_ps(position, _mm256_mul_ps(newVelocity, step));
+
+			_mm256_storeu_ps(v, _mm256_blendv_ps(velocity, newVelocity, mask));
+			_mm256_storeu_ps(p, _mm256_blendv_ps(position, newPosition, mask));
+			_mm256_storeu_ps(a, _mm256_blendv_ps(acceleration, zero, mask));
+
+			int32_t marks;
+			std::memcpy(&marks, changed + k, sizeof(marks));
+			marks |= _mm_cvtsi128_si32(_mm_and_si128(selected, ones));
+			std::memcpy(changed + k, &marks, sizeof(marks));
+		}
+
+		return k;
+	}
+
+#endif
+
+	void integrateBatch(glm::vec2 *positions, glm::vec2 *velocities, glm::vec2 *accelerations,
+						const uint8_t *flags, uint8_t *changed, size_t count,
+						uint8_t flagMask, uint8_t flagValue, float dt, SimdLevel level)
+	{
+		size_t done = 0;
+
+		// Каждый уровень обрабатывает сколько может целыми векторами, хвост добирает следующий
+#ifdef LE_INTEGRATION_X86
+		float *p = &positions[0].x;
+		float *v = &velocities[0].x;
+		float *a = &accelerations[0].x;
+		if (level == SimdLevel::AVX2)
+			done = integrateAVX2(p, v, a, flags, changed, done, count, flagMask, flagValue, dt);
+		if (level != SimdLevel::Scalar)
+			done = integrateSSE(p, v, a, flags, changed, done, count, flagMask, flagValue, dt);
+#else
+		(void)level;
+#endif
+		integrateScalar(positions, velocities, accelerations, flags, changed, done, count, flagMask, flagValue, dt);
+	}
+
+} // namespace le
@@ -0,0 +1,28 @@
+// engine/core/physics/IntegrationBatch.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include "SimdLevel.hpp"
+
+namespace le
+{
+
+	/**
+	 * @brief Явный шаг Эйлера прямо по столбцам хранилища тел.
+	 *
+	 * Для тел, у которых (flags & flagMask) == flagValue:
+	 *   v += a * dt;  p += v * dt;  a = 0;  changed = 1.
+	 * Остальные не трогаются. Тела идут по 2 (SSE) или 4 (AVX2) за раз без ветвлений:
+	 * условие считается по флагам векторно, и маска выбирает новое или старое значение.
+	 * Операции те же, что у скалярного пути, поэтому результат совпадает с ним бит в бит
+	 * на любом уровне SIMD.
+	 *
+	 * Ядро пишет только в [0, count) — непересекающиеся диапазоны тел можно
+	 * интегрировать из нескольких потоков.
+	 */
+	void integrateBatch(glm::vec2 *positions, glm::vec2 *velocities, glm::vec2 *accelerations,
+						const uint8_t *flags, uint8_t *changed, size_t count,
+						uint8_t flagMask, uint8_t flagValue, float dt, SimdLevel level = BestSimdLevel());
+
+} // namespace le
@@ -0,0 +1,150 @@
+// engine/core/physics/NarrowphaseBatch.cpp
+#include "NarrowphaseBatch.hpp"
+#include "CollisionDetection.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LE_NARROWPHASE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace le
+{
+
+	void AabbPairBatch::Clear()
+	{
+		centerAX.clear();
+		centerAY.clear();
+		halfAX.clear();
+		halfAY.clear();
+		centerBX.clear();
+		centerBY.clear();
+		halfBX.clear();
+		halfBY.clear();
+	}
+
+	void AabbPairBatch::Push(const Aabb &a, const Aabb &b)
+	{
+		centerAX.push_back(a.center.x);
+		centerAY.push_back(a.center.y);
+		halfAX.push_back(a.halfSize.x);
+		halfAY.push_back(a.halfSize.y);
+		centerBX.push_back(b.center.x);
+		centerBY.push_back(b.center.y);
+		halfBX.push_back(b.halfSize.x);
+		halfBY.push_back(b.halfSize.y);
+	}
+
+	// Пересекающаяся пара — полный контакт считает скалярный collide
+	static void emitContact(const AabbPairBatch &batch, size_t k, std::vector<uint32_t> &hits, std::vector<Contact> &contacts)
+	{
+		Contact contact = collide(batch.A(k), batch.B(k));
+		if (!contact.intersecting)
+			return;
+
+		hits.push_back(static_cast<uint32_t>(k));
+		contacts.push_back(contact);
+	}
+
+	static void collideScalar(const AabbPairBatch &batch, size_t begin, std::vector<uint32_t> &hits, std::vector<Contact> &contacts)
+	{
+		for (size_t k = begin; k < batch.Size(); ++k)
+			emitContact(batch, k, hits, contacts);
+	}
+
+#ifdef LE_NARROWPHASE_X86
+
+	// Отсев повторяет collide(Aabb, Aabb) операция в операцию:
+	//   overlap = min(maxA, maxB) - max(minA, minB), пара отброшена, если overlap <= 0.
+	// Порядок аргументов min/max подобран так, чтобы совпадать с std::min/std::max,
+	// а сравнение "не <=" пропускает NaN так же, как скалярная проверка.
+
+	static size_t collideSSE(const AabbPairBatch &batch, size_t begin, std::vector<uint32_t> &hits, std::vector<Contact> &contacts)
+	{
+		const size_t count = batch.Size();
+		const __m128 zero = _mm_setzero_ps();
+
+		size_t k = begin;
+		for (; k + 4 <= count; k += 4)
+		{
+			__m128 cax = _mm_loadu_ps(&batch.centerAX[k]);
+			__m128 cay = _mm_loadu_ps(&batch.centerAY[k]);
+			__m128 hax = _mm_loadu_ps(&batch.halfAX[k]);
+			__m128 hay = _mm_loadu_ps(&batch.halfAY[k]);
+			__m128 cbx = _mm_loadu_ps(&batch.centerBX[k]);
+			__m128 cby = _mm_loadu_ps(&batch.centerBY[k]);
+			__m128 hbx = _mm_loadu_ps(&batch.halfBX[k]);
+			__m128 hby = _mm_loadu_ps(&batch.halfBY[k]);
+
+			__m128 overlapX = _mm_sub_ps(_mm_min_ps(_mm_add_ps(cbx, hbx), _mm_add_ps(cax, hax)),
+										 _mm_max_ps(_mm_sub_ps(cbx, hbx), _mm_sub_ps(cax, hax)));
+			__m128 overlapY = _mm_sub_ps(_mm_min_ps(_mm_add_ps(cby, hby), _mm_add_ps(cay, hay)),
+										 _mm_max_ps(_mm_sub_ps(cby, hby), _mm_sub_ps(cay, hay)));
+
+			int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmpnle_ps(overlapX, zero), _mm_cmpnle_ps(overlapY, zero)));
+			while (mask)
+			{
+				int lane = __builtin_ctz(static_cast<unsigned>(mask));
+				emitContact(batch, k + static_cast<size_t>(lane), hits, contacts);
+				mask &= mask - 1;
+			}
+		}
+
+		return k;
+	}
+
+	__attribute__((target("avx2"))) static size_t collideAVX2(const AabbPairBatch &batch, size_t begin, std::vector<uint32_t> &hits, std::vector<Contact> &contacts)
+	{
+		const size_t count = batch.Size();
+		const __m256 zero = _mm256_setzero_ps();
+
+		size_t k = begin;
+		for (; k + 8 <= count; k += 8)
+		{
+			__m256 cax = _mm256_loadu_ps(&batch.centerAX[k]);
+			__m256 cay = _mm256_loadu_ps(&batch.centerAY[k]);
+			__m256 hax = _mm256_loadu_ps(&batch.halfAX[k]);
+			__m256 hay = _mm256_loadu_ps(&batch.halfAY[k]);
+			__m256 cbx = _mm256_loadu_ps(&batch.centerBX[k]);
+			__m256 cby = _mm256_loadu_ps(&batch.centerBY[k]);
+			__m256 hbx = _mm256_loadu_ps(&batch.halfBX[k]);
+			__m256 hby = _mm256_loadu_ps(&batch.halfBY[k]);
+
+			__m256 overlapX = _mm256_sub_ps(_mm256_min_ps(_mm256_add_ps(cbx, hbx), _mm256_add_ps(cax, hax)),
+											_mm256_max_ps(_mm256_sub_ps(cbx, hbx), _mm256_sub_ps(cax, hax)));
+			__m256 overlapY = _mm256_sub_ps(_mm256_min_ps(_mm256_add_ps(cby, hby), _mm256_add_ps(cay, hay)),
+											_mm256_max_ps(_mm256_sub_ps(cby, hby), _mm256_sub_ps(cay, hay)));
+
+			__m256 keep = _mm256_and_ps(_mm256_cmp_ps(overlapX, zero, _CMP_NLE_UQ), _mm256_cmp_ps(overlapY, zero, _CMP_NLE_UQ));
+			int mask = _mm256_movemask_ps(keep);
+			while (mask)
+			{
+				int lane = __builtin_ctz(static_cast<unsigned>(mask));
+				emitContact(batch, k + static_cast<size_t>(lane), hits, contacts);
+				mask &= mask - 1;
+			}
+		}
+
+		return k;
+	}
+
+#endif
+
+	size_t collideBatch(const AabbPairBatch &batch, std::vector<uint32_t> &hits, std::vector<Contact> &contacts, SimdLevel level)
+	{
+		const size_t before = hits.size();
+		size_t done = 0;
+
+		// Каждый уровень обрабатывает сколько может целыми векторами, хвост добирает следующий
+#ifdef LE_NARROWPHASE_X86
+		if (level == SimdLevel::AVX2)
+			done = collideAVX2(batch, done, hits, contacts);
+		if (level != SimdLevel::Scalar)
+			done = collideSSE(batch, done, hits, contacts);
+#else
+		(void)level;
+#endif
+		collideScalar(batch, done, hits, contacts);
+		return hits.size() - before;
+	}
+
+} // namespace le
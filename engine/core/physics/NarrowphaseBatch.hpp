@@ -0,0 +1,42 @@
+// engine/core/physics/NarrowphaseBatch.hpp
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "CollisionShapes.hpp"
+#include "SimdLevel.hpp"
+
+namespace le
+{
+
+	/**
+	 * @brief Пакет пар-кандидатов AABB–AABB в SoA-виде.
+	 *
+	 * Каждая компонента лежит в своём массиве, поэтому ядро collideBatch грузит
+	 * по 4 (SSE) или 8 (AVX2) пар одной инструкцией.
+	 */
+	struct AabbPairBatch
+	{
+		std::vector<float> centerAX, centerAY, halfAX, halfAY;
+		std::vector<float> centerBX, centerBY, halfBX, halfBY;
+
+		void Clear();
+		void Push(const Aabb &a, const Aabb &b);
+		size_t Size() const { return centerAX.size(); }
+
+		Aabb A(size_t k) const { return {{centerAX[k], centerAY[k]}, {halfAX[k], halfAY[k]}}; }
+		Aabb B(size_t k) const { return {{centerBX[k], centerBY[k]}, {halfBX[k], halfBY[k]}}; }
+	};
+
+	/**
+	 * @brief Пакетный narrowphase: проверяет все пары пакета.
+	 *
+	 * Для пересекающихся пар дописывает индекс пары в hits (по возрастанию) и контакт
+	 * в contacts. Отсев идёт векторно, а контакт считает тот же collide(Aabb, Aabb),
+	 * поэтому результат совпадает со скалярным путём бит в бит на любом уровне SIMD.
+	 *
+	 * @return число найденных контактов
+	 */
+	size_t collideBatch(const AabbPairBatch &batch, std::vector<uint32_t> &hits, std::vector<Contact> &contacts,
+						SimdLevel level = BestSimdLevel());
+
+} // namespace le
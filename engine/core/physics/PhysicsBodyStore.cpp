@@ -0,0 +1,461 @@
+// engine/core/physics/PhysicsBodyStore.cpp
+#include "PhysicsBodyStore.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/trigonometric.hpp>
+#include <engine/core/ecs/components/CoreComponents.hpp>
+#include <engine/core/ecs/components/PhysicsComponents.hpp>
+
+namespace le
+{
+
+	void PhysicsBodyStore::Connect(entt::registry &registry)
+	{
+		if (m_registry == &registry)
+			return;
+
+		Disconnect();
+		m_registry = &registry;
+
+		registry.on_construct<Rigidbody2D>().connect<&PhysicsBodyStore::OnBodyConstruct>(*this);
+		registry.on_destroy<Rigidbody2D>().connect<&PhysicsBodyStore::OnBodyDestroy>(*this);
+		registry.on_update<Rigidbody2D>().connect<&PhysicsBodyStore::OnPropertiesChanged>(*this);
+		registry.on_construct<BoxCollider2D>().connect<&PhysicsBodyStore::OnPropertiesChanged>(*this);
+		registry.on_construct<CircleCollider2D>().connect<&PhysicsBodyStore::OnPropertiesChanged>(*this);
+		registry.on_update<BoxCollider2D>().connect<&PhysicsBodyStore::OnPropertiesChanged>(*this);
+		registry.on_update<CircleCollider2D>().connect<&PhysicsBodyStore::OnPropertiesChanged>(*this);
+		registry.on_destroy<BoxCollider2D>().connect<&PhysicsBodyStore::OnPropertiesChanged>(*this);
+		registry.on_destroy<CircleCollider2D>().connect<&PhysicsBodyStore::OnPropertiesChanged>(*this);
+
+		// Тела, созданные до подключения
+		for (auto entity : registry.view<Rigidbody2D>())
+		{
+			AddBody(entity);
+		}
+	}
+
+	void PhysicsBodyStore::Disconnect()
+	{
+		if (m_registry == nullptr)
+			return;
+
+		m_registry->on_construct<Rigidbody2D>().disconnect(this);
+		m_registry->on_destroy<Rigidbody2D>().disconnect(this);
+		m_registry->on_update<Rigidbody2D>().disconnect(this);
+		m_registry->on_construct<BoxCollider2D>().disconnect(this);
+		m_registry->on_construct<CircleCollider2D>().disconnect(this);
+		m_registry->on_update<BoxCollider2D>().disconnect(this);
+		m_registry->on_update<CircleCollider2D>().disconnect(this);
+		m_registry->on_destroy<BoxCollider2D>().disconnect(this);
+		m_registry->on_destroy<CircleCollider2D>().disconnect(this);
+		m_registry = nullptr;
+
+		entities.clear();
+		positions.clear();
+		previousPositions.clear();
+		velocities.clear();
+		accelerations.clear();
+		offsets.clear();
+		halfSizes.clear();
+		localOffsets.clear();
+		boxHalfSizes.clear();
+		radii.clear();
+		shapes.clear();
+		rotations.clear();
+		axes.clear();
+		categories.clear();
+		masks.clear();
+		invMasses.clear();
+		restitutions.clear();
+		frictions.clear();
+		flags.clear();
+		changed.clear();
+		sleepTimes.clear();
+		islandIds.clear();
+		m_slotOfEntity.clear();
+		m_dirty.clear();
+		m_islandsToWake.clear();
+		++m_staticVersion;
+		++m_layoutVersion;
+	}
+
+	uint32_t PhysicsBodyStore::SlotOf(entt::entity entity) const
+	{
+		auto id = static_cast<size_t>(entt::to_entity(entity));
+		if (id >= m_slotOfEntity.size())
+			return k_invalidSlot;
+
+		uint32_t slot = m_slotOfEntity[id];
+		if (slot == k_invalidSlot || entities[slot] != entity)
+			return k_invalidSlot;
+
+		return slot;
+	}
+
+	void PhysicsBodyStore::OnBodyConstruct(entt::registry & /*registry*/, entt::entity entity)
+	{
+		AddBody(entity);
+	}
+
+	void PhysicsBodyStore::OnBodyDestroy(entt::registry & /*registry*/, entt::entity entity)
+	{
+		RemoveBody(entity);
+	}
+
+	void PhysicsBodyStore::OnPropertiesChanged(entt::registry & /*registry*/, entt::entity entity)
+	{
+		uint32_t slot = SlotOf(entity);
+		if (slot != k_invalidSlot)
+			m_dirty[slot] = 1;
+	}
+
+	void PhysicsBodyStore::AddBody(entt::entity entity)
+	{
+		if (SlotOf(entity) != k_invalidSlot)
+			return;
+
+		auto id = static_cast<size_t>(entt::to_entity(entity));
+		if (id >= m_slotOfEntity.size())
+			m_slotOfEntity.resize(id + 1, k_invalidSlot);
+
+		m_slotOfEntity[id] = static_cast<uint32_t>(entities.size());
+
+		entities.push_back(entity);
+		positions.emplace_back(0.0f);
+		previousPositions.emplace_back(0.0f);
+		velocities.emplace_back(0.0f);
+		accelerations.emplace_back(0.0f);
+		offsets.emplace_back(0.0f);
+		halfSizes.emplace_back(0.0f);
+		localOffsets.emplace_back(0.0f);
+		boxHalfSizes.emplace_back(0.0f);
+		radii.push_back(0.0f);
+		shapes.push_back(Shape::None);
+		rotations.push_back(0.0f);
+		axes.emplace_back(1.0f, 0.0f);
+		categories.push_back(0);
+		masks.push_back(0);
+		invMasses.push_back(0.0f);
+		restitutions.push_back(0.0f);
+		frictions.push_back(0.0f);
+		flags.push_back(0);
+		changed.push_back(0);
+		sleepTimes.push_back(0.0f);
+		islandIds.push_back(0);
+
+		// Компоненты обычно настраиваются сразу после emplace — читаем свойства
+		// не здесь, а в ближайшем Sync()
+		m_dirty.push_back(1);
+		++m_layoutVersion;
+	}
+
+	void PhysicsBodyStore::RemoveBody(entt::entity entity)
+	{
+		uint32_t slot = SlotOf(entity);
+		if (slot == k_invalidSlot)
+			return;
+
+		// Соседи по острову лишились опоры
+		if (IsSleeping(slot))
+			WakeIsland(islandIds[slot]);
+
+		// swap-and-pop: последний слот переезжает на место удалённого
+		size_t last = entities.size() - 1;
+
+		// Статика удалена или сменила слот — разбиение статики устарело
+		if (IsStaticGeometry(slot) || IsStaticGeometry(last))
+			++m_staticVersion;
+		++m_layoutVersion;
+		if (slot != last)
+		{
+			entities[slot] = entities[last];
+			positions[slot] = positions[last];
+			previousPositions[slot] = previousPositions[last];
+			velocities[slot] = velocities[last];
+			accelerations[slot] = accelerations[last];
+			offsets[slot] = offsets[last];
+			halfSizes[slot] = halfSizes[last];
+			localOffsets[slot] = localOffsets[last];
+			boxHalfSizes[slot] = boxHalfSizes[last];
+			radii[slot] = radii[last];
+			shapes[slot] = shapes[last];
+			rotations[slot] = rotations[last];
+			axes[slot] = axes[last];
+			categories[slot] = categories[last];
+			masks[slot] = masks[last];
+			invMasses[slot] = invMasses[last];
+			restitutions[slot] = restitutions[last];
+			frictions[slot] = frictions[last];
+			flags[slot] = flags[last];
+			changed[slot] = changed[last];
+			sleepTimes[slot] = sleepTimes[last];
+			islandIds[slot] = islandIds[last];
+			m_dirty[slot] = m_dirty[last];
+
+			m_slotOfEntity[static_cast<size_t>(entt::to_entity(entities[slot]))] = slot;
+		}
+
+		entities.pop_back();
+		positions.pop_back();
+		previousPositions.pop_back();
+		velocities.pop_back();
+		accelerations.pop_back();
+		offsets.pop_back();
+		halfSizes.pop_back();
+		localOffsets.pop_back();
+		boxHalfSizes.pop_back();
+		radii.pop_back();
+		shapes.pop_back();
+		rotations.pop_back();
+		axes.pop_back();
+		categories.pop_back();
+		masks.pop_back();
+		invMasses.pop_back();
+		restitutions.pop_back();
+		frictions.pop_back();
+		flags.pop_back();
+		changed.pop_back();
+		sleepTimes.pop_back();
+		islandIds.pop_back();
+		m_dirty.pop_back();
+
+		m_slotOfEntity[static_cast<size_t>(entt::to_entity(entity))] = k_invalidSlot;
+	}
+
+	void PhysicsBodyStore::RefreshProperties(entt::registry &registry, size_t slot)
+	{
+		entt::entity entity = entities[slot];
+		auto &rb = registry.get<Rigidbody2D>(entity);
+
+		// Тело было или стало статикой (или у статики сменился коллайдер)
+		if (IsStaticGeometry(slot))
+			++m_staticVersion;
+
+		uint8_t bodyFlags = flags[slot] & (Active | HasTransform | Sleeping);
+		if (rb.GetKinematic())
+			bodyFlags |= Kinematic;
+		if (rb.GetStatic())
+			bodyFlags |= Static;
+		if (rb.isBullet)
+			bodyFlags |= Bullet;
+
+		invMasses[slot] = rb.GetMass();
+		restitutions[slot] = rb.restitution;
+		frictions[slot] = rb.friction;
+
+		if (const auto *collider = registry.try_get<BoxCollider2D>(entity))
+		{
+			bodyFlags |= Collider;
+			shapes[slot] = Shape::Box;
+			localOffsets[slot] = collider->offset;
+			boxHalfSizes[slot] = collider->halfSize();
+			radii[slot] = 0.0f;
+			categories[slot] = collider->categoryBits;
+			masks[slot] = collider->maskBits;
+			if (collider->isTrigger)
+				bodyFlags |= Trigger;
+		}
+		else if (const auto *circle = registry.try_get<CircleCollider2D>(entity))
+		{
+			bodyFlags |= Collider;
+			shapes[slot] = Shape::Circle;
+			localOffsets[slot] = circle->offset;
+			boxHalfSizes[slot] = glm::vec2(circle->radius);
+			radii[slot] = circle->radius;
+			categories[slot] = circle->categoryBits;
+			masks[slot] = circle->maskBits;
+			if (circle->isTrigger)
+				bodyFlags |= Trigger;
+		}
+		else
+		{
+			shapes[slot] = Shape::None;
+			localOffsets[slot] = glm::vec2(0.0f);
+			boxHalfSizes[slot] = glm::vec2(0.0f);
+			radii[slot] = 0.0f;
+			categories[slot] = 0;
+			masks[slot] = 0;
+		}
+
+		// Статическое / кинематическое тело не спит
+		if (bodyFlags & (Kinematic | Static))
+			bodyFlags &= static_cast<uint8_t>(~Sleeping);
+
+		flags[slot] = bodyFlags;
+		m_dirty[slot] = 0;
+		UpdateOrientation(slot);
+		++m_layoutVersion;
+
+		if (IsStaticGeometry(slot))
+			++m_staticVersion;
+	}
+
+	void PhysicsBodyStore::Sync(entt::registry &registry)
+	{
+		for (size_t i = 0; i < entities.size(); ++i)
+		{
+			// Позиция прошлого шага есть только у тела, которое уже синхронизировалось
+			const bool hadTransform = (flags[i] & HasTransform) != 0;
+			if (m_dirty[i])
+				RefreshProperties(registry, i);
+
+			entt::entity entity = entities[i];
+			changed[i] = 0;
+			const uint8_t oldFlags = flags[i];
+
+			const auto *transform = registry.try_get<Transform>(entity);
+			if (transform == nullptr)
+			{
+				flags[i] &= static_cast<uint8_t>(~(HasTransform | Active));
+				if (flags[i] != oldFlags)
+				{
+					++m_layoutVersion;
+					if (IsStaticGeometry(i))
+						++m_staticVersion;
+				}
+				continue;
+			}
+			flags[i] |= HasTransform;
+
+			const auto *active = registry.try_get<ActiveComponent>(entity);
+			if (active == nullptr || active->isActive)
+				flags[i] |= Active;
+			else
+				flags[i] &= static_cast<uint8_t>(~Active);
+
+			if (flags[i] != oldFlags)
+				++m_layoutVersion;
+
+			// Поворот меняется редко — границы пересчитываются только тогда
+			const bool rotated = rotations[i] != transform->rotation;
+			if (rotated)
+			{
+				rotations[i] = transform->rotation;
+				UpdateOrientation(i);
+			}
+
+			// Статику двигают только скрипты — сравниваем с прошлым кадром
+			if (IsStaticGeometry(i) && (flags[i] != oldFlags || rotated || positions[i] != transform->position))
+				++m_staticVersion;
+
+			// Спящее тело сдвинули или повернули скриптом — разбиение спящих устарело
+			if (IsSleeping(i) && (flags[i] != oldFlags || rotated || positions[i] != transform->position))
+				++m_sleepVersion;
+
+			// Кинематику двигают скрипты между шагами: её previousPositions — позиция
+			// прошлого шага, иначе сдвиг не виден ни сну, ни broadphase
+			const auto &rb = registry.get<Rigidbody2D>(entity);
+			const bool kinematic = (flags[i] & Kinematic) != 0;
+			previousPositions[i] = kinematic && hadTransform ? positions[i] : transform->position;
+			positions[i] = transform->position;
+			velocities[i] = rb.velocity;
+			accelerations[i] = rb.acceleration;
+
+			if (IsDynamic(i))
+				SyncSleep(i, rb.IsSleeping());
+		}
+
+		ApplyWakes();
+	}
+
+	void PhysicsBodyStore::UpdateOrientation(size_t slot)
+	{
+		float cosine = std::cos(glm::radians(rotations[slot]));
+		float sine = std::sin(glm::radians(rotations[slot]));
+
+		// Кратные 90° — точные оси: ящик остаётся AABB и идёт быстрым путём
+		constexpr float k_axisEpsilon = 1e-6f;
+		if (std::abs(sine) < k_axisEpsilon)
+		{
+			sine = 0.0f;
+			cosine = cosine < 0.0f ? -1.0f : 1.0f;
+		}
+		else if (std::abs(cosine) < k_axisEpsilon)
+		{
+			cosine = 0.0f;
+			sine = sine < 0.0f ? -1.0f : 1.0f;
+		}
+		axes[slot] = {cosine, sine};
+
+		const glm::vec2 &local = localOffsets[slot];
+		const glm::vec2 &half = boxHalfSizes[slot];
+		offsets[slot] = {cosine * local.x - sine * local.y, sine * local.x + cosine * local.y};
+
+		// Круг от поворота не меняется — сдвигается только его центр
+		if (shapes[slot] == Shape::Circle)
+		{
+			axes[slot] = {1.0f, 0.0f};
+			halfSizes[slot] = half;
+			return;
+		}
+
+		halfSizes[slot] = {std::abs(cosine) * half.x + std::abs(sine) * half.y,
+						   std::abs(sine) * half.x + std::abs(cosine) * half.y};
+	}
+
+	void PhysicsBodyStore::SyncSleep(size_t slot, bool componentSleeping)
+	{
+		if (IsSleeping(slot))
+		{
+			// Разбудили скриптом или приложили силу / задали скорость — просыпается весь остров
+			bool pushed = velocities[slot] != glm::vec2(0.0f) || accelerations[slot] != glm::vec2(0.0f);
+			if (!componentSleeping || pushed)
+				WakeIsland(islandIds[slot]);
+		}
+		else if (componentSleeping)
+		{
+			// Скрипт усыпил тело сам (например, обломки при загрузке уровня)
+			Sleep(slot, NewIslandId());
+		}
+	}
+
+	void PhysicsBodyStore::Sleep(size_t slot, uint32_t island)
+	{
+		flags[slot] |= Sleeping;
+		islandIds[slot] = island;
+		++m_sleepVersion;
+		velocities[slot] = glm::vec2(0.0f);
+		accelerations[slot] = glm::vec2(0.0f);
+		MarkChanged(slot);
+	}
+
+	void PhysicsBodyStore::ApplyWakes()
+	{
+		if (m_islandsToWake.empty())
+			return;
+
+		std::sort(m_islandsToWake.begin(), m_islandsToWake.end());
+		m_islandsToWake.erase(std::unique(m_islandsToWake.begin(), m_islandsToWake.end()), m_islandsToWake.end());
+
+		for (size_t i = 0; i < entities.size(); ++i)
+		{
+			if (!IsSleeping(i) || !std::binary_search(m_islandsToWake.begin(), m_islandsToWake.end(), islandIds[i]))
+				continue;
+
+			flags[i] &= static_cast<uint8_t>(~Sleeping);
+			sleepTimes[i] = 0.0f;
+			MarkChanged(i);
+			++m_sleepVersion;
+		}
+
+		m_islandsToWake.clear();
+	}
+
+	void PhysicsBodyStore::WriteBack(entt::registry &registry)
+	{
+		for (size_t i = 0; i < entities.size(); ++i)
+		{
+			if (!changed[i])
+				continue;
+
+			entt::entity entity = entities[i];
+			auto &rb = registry.get<Rigidbody2D>(entity);
+			registry.get<Transform>(entity).position = positions[i];
+			rb.velocity = velocities[i];
+			rb.acceleration = accelerations[i];
+			rb.SetSleeping(IsSleeping(i));
+			changed[i] = 0;
+		}
+	}
+
+} // namespace le
@@ -0,0 +1,179 @@
+// engine/core/physics/PhysicsBodyStore.hpp
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+
+#include <extern/entt/entt.hpp>
+
+namespace le
+{
+
+	/**
+	 * @brief Постоянное SoA-хранилище физических тел.
+	 *
+	 * Каждому Rigidbody2D соответствует слот. Состав хранилища поддерживается
+	 * сигналами entt (on_construct / on_destroy / on_update), поэтому массивы не
+	 * пересобираются каждый кадр, а солвер работает с непрерывной памятью.
+	 *
+	 * Свойства тела (масса, флаги, упругость, трение, размеры коллайдера) кэшируются
+	 * и перечитываются только для "грязных" слотов. Изменил их во время игры —
+	 * сообщи через registry.patch<Rigidbody2D>(entity) / patch<BoxCollider2D>(entity)
+	 * (patch<CircleCollider2D>(entity)). Если на сущности оба коллайдера — берётся ящик.
+	 * Позиция, скорость и ускорение читаются каждый кадр (их меняют скрипты).
+	 * Поворот тоже, но оси и описанный AABB пересчитываются, только когда он изменился.
+	 * Там же проверяется сон: спящее тело, которому задали скорость или ускорение
+	 * (или вызвали Rigidbody2D::WakeUp), будит весь свой остров.
+	 */
+	class PhysicsBodyStore
+	{
+	public:
+		enum class Shape : uint8_t
+		{
+			None,
+			Box,
+			Circle,
+		};
+
+		enum BodyFlags : uint8_t
+		{
+			Kinematic = 1 << 0,
+			Static = 1 << 1,
+			Collider = 1 << 2,
+			Active = 1 << 3,
+			HasTransform = 1 << 4,
+			Sleeping = 1 << 5,
+			Trigger = 1 << 6,
+			Bullet = 1 << 7,
+		};
+
+		static constexpr uint32_t k_invalidSlot = UINT32_MAX;
+
+		PhysicsBodyStore() = default;
+		~PhysicsBodyStore() { Disconnect(); }
+
+		// Хранилище подписано на сигналы реестра через this — копировать нельзя
+		PhysicsBodyStore(const PhysicsBodyStore &) = delete;
+		PhysicsBodyStore &operator=(const PhysicsBodyStore &) = delete;
+
+		// Подписывается на сигналы реестра и забирает уже существующие тела
+		void Connect(entt::registry &registry);
+		void Disconnect();
+		bool IsConnectedTo(const entt::registry &registry) const { return m_registry == &registry; }
+
+		// Перечитывает "грязные" свойства и текущее состояние (позиция, скорость, ускорение)
+		void Sync(entt::registry &registry);
+		// Записывает в компоненты только изменённые тела
+		void WriteBack(entt::registry &registry);
+
+		size_t Size() const { return entities.size(); }
+		uint32_t SlotOf(entt::entity entity) const;
+
+		bool IsDynamic(size_t slot) const { return (flags[slot] & (Kinematic | Static)) == 0; }
+		bool IsActive(size_t slot) const { return (flags[slot] & Active) != 0; }
+		// Есть коллайдер — ящик или круг (см. shapes)
+		bool HasCollider(size_t slot) const { return (flags[slot] & Collider) != 0; }
+		bool IsCircle(size_t slot) const { return shapes[slot] == Shape::Circle; }
+		bool IsSimulated(size_t slot) const { return (flags[slot] & HasTransform) != 0; }
+		bool IsSleeping(size_t slot) const { return (flags[slot] & Sleeping) != 0; }
+		// Коллайдер-триггер: пересечения дают события, но не контакты солвера
+		bool IsTrigger(size_t slot) const { return (flags[slot] & Trigger) != 0; }
+		// Rigidbody2D::isBullet — тело всегда идёт через CCD
+		bool IsBullet(size_t slot) const { return (flags[slot] & Bullet) != 0; }
+		// Ящик повёрнут не на кратный 90° угол: пересечения — через SAT, а не по AABB
+		bool IsOriented(size_t slot) const { return axes[slot].x != 0.0f && axes[slot].y != 0.0f; }
+		// Динамическое тело, которое сейчас двигается солвером
+		bool IsAwake(size_t slot) const { return IsDynamic(slot) && !IsSleeping(slot); }
+		// Кинематическое тело, которое скрипт сдвинул с прошлого шага
+		bool IsMovedKinematic(size_t slot) const
+		{
+			return (flags[slot] & Kinematic) != 0 && positions[slot] != previousPositions[slot];
+		}
+		// Тело двигается в этом шаге — только такие тела ищут пары со спящими и будят их
+		bool IsMoving(size_t slot) const { return IsAwake(slot) || IsMovedKinematic(slot); }
+		// Слои: пара нужна, только если категория каждого тела есть в маске другого
+		bool CanCollide(size_t a, size_t b) const
+		{
+			return (categories[a] & masks[b]) != 0 && (categories[b] & masks[a]) != 0;
+		}
+		// Статическая геометрия уровня: не двигается ни солвером, ни (обычно) скриптами.
+		// Кинематика сюда не входит — её двигают каждый кадр.
+		bool IsStaticGeometry(size_t slot) const { return (flags[slot] & (Kinematic | Static)) == Static; }
+
+		// Меняется, когда статика добавлена, удалена, сдвинута, включена/выключена
+		// или сменила слот. Совпала с прошлым кадром — разбиение статики можно не трогать.
+		uint32_t StaticVersion() const { return m_staticVersion; }
+		// Меняется, когда тело добавлено или удалено (слоты сдвинулись), перечитаны его
+		// свойства или оно включено/выключено. Позиции сюда не входят.
+		uint32_t LayoutVersion() const { return m_layoutVersion; }
+		// Меняется, когда тело уснуло или проснулось, а также когда спящее тело сдвинули,
+		// повернули или выключили. Вместе с LayoutVersion — ключ разбиения спящих тел.
+		uint32_t SleepVersion() const { return m_sleepVersion; }
+
+		// === Сон ===
+		// Усыпляет тело как часть острова island (скорость и ускорение обнуляются)
+		void Sleep(size_t slot, uint32_t island);
+		uint32_t NewIslandId() { return m_nextIslandId++; }
+		// Остров разбудят в ближайшем ApplyWakes()
+		void WakeIsland(uint32_t island) { m_islandsToWake.push_back(island); }
+		// Будит все тела отложенных островов
+		void ApplyWakes();
+		// Состояние сна вне столбцов — для снимков физики
+		uint32_t GetNextIslandId() const { return m_nextIslandId; }
+		const std::vector<uint32_t> &GetPendingWakes() const { return m_islandsToWake; }
+		void RestoreIslands(uint32_t nextIslandId, const uint32_t *pendingWakes, size_t count)
+		{
+			m_nextIslandId = nextIslandId;
+			m_islandsToWake.assign(pendingWakes, pendingWakes + count);
+		}
+
+		// Отмечает тело как изменённое физикой — его запишет WriteBack
+		void MarkChanged(size_t slot) { changed[slot] = 1; }
+
+		// === SoA-данные (индекс = слот) ===
+		std::vector<entt::entity> entities;
+		std::vector<glm::vec2> positions;	  // Transform::position
+		std::vector<glm::vec2> previousPositions; // позиция в начале шага (для интерполяции), у кинематики — прошлого шага
+		std::vector<glm::vec2> velocities;	  // Rigidbody2D::velocity
+		std::vector<glm::vec2> accelerations; // Rigidbody2D::acceleration
+		std::vector<glm::vec2> offsets;		  // offset коллайдера, повёрнутый вместе с телом
+		std::vector<glm::vec2> halfSizes;	  // половины мирового AABB (у повёрнутого ящика — описанного)
+		std::vector<glm::vec2> localOffsets;  // offset коллайдера
+		std::vector<glm::vec2> boxHalfSizes;  // BoxCollider2D::size * 0.5 в осях тела; у круга — (r, r)
+		std::vector<float> radii;			  // CircleCollider2D::radius, у ящика 0
+		std::vector<Shape> shapes;
+		std::vector<float> rotations;		  // Transform::rotation (градусы), по нему кэшированы axes
+		std::vector<glm::vec2> axes;		  // (cos, sin) поворота — ось X ящика в мире; у круга (1, 0)
+		std::vector<uint32_t> categories;	  // categoryBits коллайдера
+		std::vector<uint32_t> masks;		  // maskBits коллайдера
+		std::vector<float> invMasses;		  // 1 / mass, 0 — бесконечная масса
+		std::vector<float> restitutions;
+		std::vector<float> frictions;
+		std::vector<uint8_t> flags;	  // BodyFlags
+		std::vector<uint8_t> changed; // тело изменено в этом шаге
+		std::vector<float> sleepTimes;	  // сколько секунд тело почти не двигается
+		std::vector<uint32_t> islandIds;  // остров, с которым тело уснуло
+
+	private:
+		void OnBodyConstruct(entt::registry &registry, entt::entity entity);
+		void OnBodyDestroy(entt::registry &registry, entt::entity entity);
+		void OnPropertiesChanged(entt::registry &registry, entt::entity entity);
+
+		void AddBody(entt::entity entity);
+		void RemoveBody(entt::entity entity);
+		void RefreshProperties(entt::registry &registry, size_t slot);
+		void SyncSleep(size_t slot, bool componentSleeping);
+		// Пересчитывает axes, offsets и halfSizes по rotations / localOffsets / boxHalfSizes
+		void UpdateOrientation(size_t slot);
+
+		entt::registry *m_registry = nullptr;
+		std::vector<uint32_t> m_slotOfEntity; // entt::to_entity(entity) -> слот
+		std::vector<uint8_t> m_dirty;		  // свойства нужно перечитать
+		std::vector<uint32_t> m_islandsToWake;
+		uint32_t m_nextIslandId = 0;
+		uint32_t m_staticVersion = 0;
+		uint32_t m_layoutVersion = 0;
+		uint32_t m_sleepVersion = 0;
+	};
+
+} // namespace le
@@ -0,0 +1,110 @@
+// engine/core/physics/PhysicsSnapshot.cpp
+#include "PhysicsSnapshot.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace le
+{
+
+	namespace
+	{
+		// Серия дельты: [начало в словах, число слов], затем сами слова
+		struct Run
+		{
+			uint32_t start;
+			uint32_t count;
+		};
+
+		constexpr size_t k_word = sizeof(uint64_t);
+		constexpr size_t k_block = 8; // слов — одинаковые блоки пропускаются одним memcmp
+
+		void AppendBytes(std::vector<uint8_t> &out, const void *data, size_t size)
+		{
+			const size_t at = out.size();
+			out.resize(at + size);
+			std::memcpy(out.data() + at, data, size);
+		}
+	}
+
+	void PhysicsSnapshot::Clear()
+	{
+		m_bytes.clear();
+		m_imageSize = 0;
+		m_step = 0;
+		m_isDelta = false;
+		m_baseStep = 0;
+		m_baseSize = 0;
+	}
+
+	void PhysicsSnapshot::EncodeDelta(const std::vector<uint8_t> &image, const PhysicsSnapshot &base)
+	{
+		// Образы выровнены на слово; хвост за концом опоры идёт одной серией
+		const uint8_t *current = image.data();
+		const uint8_t *previous = base.m_bytes.data();
+		const size_t words = image.size() / k_word;
+		const size_t common = std::min(image.size(), base.m_bytes.size()) / k_word;
+
+		m_bytes.clear();
+		m_isDelta = true;
+		m_imageSize = image.size();
+		m_baseStep = base.m_step;
+		m_baseSize = base.m_bytes.size();
+
+		auto differs = [&](size_t word)
+		{
+			return word >= common || std::memcmp(current + word * k_word, previous + word * k_word, k_word) != 0;
+		};
+
+		size_t word = 0;
+		while (word < words)
+		{
+			// Совпадающие блоки пропускаем целиком
+			if (word + k_block <= common &&
+				std::memcmp(current + word * k_word, previous + word * k_word, k_block * k_word) == 0)
+			{
+				word += k_block;
+				continue;
+			}
+			if (!differs(word))
+			{
+				++word;
+				continue;
+			}
+
+			const size_t start = word;
+			while (word < words && differs(word))
+				++word;
+
+			const Run run{static_cast<uint32_t>(start), static_cast<uint32_t>(word - start)};
+			AppendBytes(m_bytes, &run, sizeof(run));
+			AppendBytes(m_bytes, current + start * k_word, run.count * k_word);
+		}
+	}
+
+	bool PhysicsSnapshot::DecodeDelta(const PhysicsSnapshot &base, std::vector<uint8_t> &image) const
+	{
+		if (base.m_isDelta || base.m_step != m_baseStep || base.m_bytes.size() != m_baseSize)
+			return false;
+
+		image.resize(m_imageSize);
+		std::memcpy(image.data(), base.m_bytes.data(), std::min(m_imageSize, base.m_bytes.size()));
+
+		size_t at = 0;
+		while (at + sizeof(Run) <= m_bytes.size())
+		{
+			Run run;
+			std::memcpy(&run, m_bytes.data() + at, sizeof(run));
+			at += sizeof(run);
+
+			const size_t size = static_cast<size_t>(run.count) * k_word;
+			if (at + size > m_bytes.size() || (static_cast<size_t>(run.start) * k_word + size) > image.size())
+				return false;
+
+			std::memcpy(image.data() + static_cast<size_t>(run.start) * k_word, m_bytes.data() + at, size);
+			at += size;
+		}
+		return true;
+	}
+
+} // namespace le
@@ -0,0 +1,50 @@
+// engine/core/physics/PhysicsSnapshot.hpp
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace le
+{
+
+	/**
+	 * @brief Снимок состояния физики для отката (rollback) и перемотки.
+	 *
+	 * Один непрерывный буфер: столбцы хранилища тел, которые меняет симуляция
+	 * (позиции, скорости, ускорения, сон), и записи кэшей контактов и триггеров.
+	 * Свойства тел (масса, коллайдеры, слои) — данные игры, в снимок не входят.
+	 *
+	 * Full — весь образ. Delta — только изменившиеся 8-байтовые слова относительно
+	 * опорного полного снимка: покоящиеся и статические тела места почти не занимают.
+	 * Восстановление дельты требует ровно один опорный снимок, цепочек нет.
+	 *
+	 * Создаётся и читается PhysicsSystem::SaveSnapshot / RestoreSnapshot. Буфер
+	 * переиспользуется: повторное сохранение в тот же снимок память не выделяет.
+	 */
+	class PhysicsSnapshot
+	{
+	public:
+		bool IsEmpty() const { return m_bytes.empty(); }
+		bool IsDelta() const { return m_isDelta; }
+		// Шаг физики, после которого снят снимок
+		uint64_t GetStep() const { return m_step; }
+		size_t ByteSize() const { return m_bytes.size(); }
+		void Clear();
+
+	private:
+		friend class PhysicsSystem;
+
+		// Кодирует image как дельту к полному снимку base
+		void EncodeDelta(const std::vector<uint8_t> &image, const PhysicsSnapshot &base);
+		// Собирает образ дельты поверх base. false — base не тот, от которого она снята.
+		bool DecodeDelta(const PhysicsSnapshot &base, std::vector<uint8_t> &image) const;
+
+		std::vector<uint8_t> m_bytes; // Full — образ; Delta — серии изменённых слов
+		size_t m_imageSize = 0;		  // размер образа (у дельты — после раскодирования)
+		uint64_t m_step = 0;
+		bool m_isDelta = false;
+		uint64_t m_baseStep = 0; // у дельты — шаг и размер опорного снимка
+		size_t m_baseSize = 0;
+	};
+
+} // namespace le
@@ -0,0 +1,25 @@
+// engine/core/physics/SimdLevel.cpp
+#include "SimdLevel.hpp"
+
+namespace le
+{
+
+	SimdLevel BestSimdLevel()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		static const SimdLevel level = []
+		{
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2"))
+				return SimdLevel::AVX2;
+			if (__builtin_cpu_supports("sse2"))
+				return SimdLevel::SSE;
+			return SimdLevel::Scalar;
+		}();
+		return level;
+#else
+		return SimdLevel::Scalar;
+#endif
+	}
+
+} // namespace le
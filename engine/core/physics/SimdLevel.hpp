@@ -0,0 +1,19 @@
+// engine/core/physics/SimdLevel.hpp
+#pragma once
+
+namespace le
+{
+
+	// Набор инструкций для пакетных ядер физики (narrowphase, интегратор).
+	// Выбирается один раз при старте; каждое ядро обязано совпадать со скалярным путём.
+	enum class SimdLevel
+	{
+		Scalar,
+		SSE,
+		AVX2,
+	};
+
+	// Лучший набор инструкций, доступный на этом процессоре (проверяется один раз)
+	SimdLevel BestSimdLevel();
+
+} // namespace le
@@ -2,7 +2,11 @@
 #pragma once
 #include <unordered_map>
 #include <vector>
-#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <cmath>
+#include <limits>
 #include <glm/glm.hpp>
 #include <iostream>
 
@@ -14,9 +18,44 @@ public:
 		std::vector<size_t> entities;
 	};
 
-	SpatialHashGrid(float cellSize) : cellSize(cellSize) {}
+	// Режим хранения ячеек:
+	// Hashed — unordered_map ячеек, у каждой свой vector (старое поведение);
+	// Flat   — плоская сетка: counting sort строит массив начала ячеек и один
+	//          непрерывный массив индексов. После "прогрева" память не выделяется.
+	enum class Mode
+	{
+		Hashed,
+		Flat
+	};
+
+	SpatialHashGrid(float cellSize, Mode mode = Mode::Hashed) : cellSize(cellSize), m_mode(mode) {}
 
-	void ClearGrid() { m_grid.clear(); }
+	Mode GetMode() const { return m_mode; }
+
+	void SetMode(Mode mode)
+	{
+		if (m_mode == mode)
+			return;
+
+		ClearGrid();
+		m_mode = mode;
+	}
+
+	void ClearGrid()
+	{
+		if (m_mode == Mode::Flat)
+		{
+			// clear() сохраняет capacity — следующий кадр ничего не выделяет
+			m_items.clear();
+			m_cellEntities.clear();
+			m_cellStart.assign(1, 0);
+			m_cols = 0;
+			m_rows = 0;
+			return;
+		}
+
+		m_grid.clear();
+	}
 
 	size_t Hash(const glm::vec2 &pos) const
 	{
@@ -37,6 +76,13 @@ public:
 		int minY = static_cast<int>(std::floor(minCorner.y / cellSize));
 		int maxY = static_cast<int>(std::floor(maxCorner.y / cellSize));
 
+		if (m_mode == Mode::Flat)
+		{
+			// Во flat-режиме только запоминаем диапазон — раскладка по ячейкам в Build()
+			m_items.push_back({static_cast<uint32_t>(entityIndex), minX, minY, maxX, maxY, minCorner, maxCorner});
+			return;
+		}
+
 		for (int x = minX; x <= maxX; ++x)
 		{
 			for (int y = minY; y <= maxY; ++y)
@@ -47,8 +93,133 @@ public:
 		}
 	}
 
-	void ForEachNear(const glm::vec2 &pos, const std::function<void(size_t)> &callback) const
+	// Раскладывает вставленные объекты по ячейкам (только для Mode::Flat).
+	// Вызывать после всех InsertGrid и до запросов.
+	void Build()
+	{
+		if (m_mode != Mode::Flat)
+			return;
+
+		m_cellEntities.clear();
+
+		if (m_items.empty())
+		{
+			m_cellStart.assign(1, 0);
+			m_cols = 0;
+			m_rows = 0;
+			return;
+		}
+
+		// === 1. Границы занятой области (в ячейках cellSize) ===
+		int minX = m_items[0].minX, minY = m_items[0].minY;
+		int maxX = m_items[0].maxX, maxY = m_items[0].maxY;
+		for (const FlatItem &item : m_items)
+		{
+			minX = std::min(minX, item.minX);
+			minY = std::min(minY, item.minY);
+			maxX = std::max(maxX, item.maxX);
+			maxY = std::max(maxY, item.maxY);
+		}
+
+		// === 2. Ограничиваем число ячеек ===
+		// Одиночный объект далеко от остальных не должен раздувать сетку до миллионов ячеек:
+		// укрупняем ячейки вдвое, пока сетка не поместится в лимит. Результат остаётся
+		// корректным — просто кандидатов в ячейке становится больше.
+		const int64_t maxCells = std::max<int64_t>(k_minFlatCells, static_cast<int64_t>(m_items.size()) * k_flatCellsPerItem);
+		m_shift = 0;
+		while ((static_cast<int64_t>(FloorShift(maxX, m_shift)) - FloorShift(minX, m_shift) + 1) *
+				   (static_cast<int64_t>(FloorShift(maxY, m_shift)) - FloorShift(minY, m_shift) + 1) >
+			   maxCells)
+		{
+			++m_shift;
+		}
+
+		m_originX = FloorShift(minX, m_shift);
+		m_originY = FloorShift(minY, m_shift);
+		m_cols = FloorShift(maxX, m_shift) - m_originX + 1;
+		m_rows = FloorShift(maxY, m_shift) - m_originY + 1;
+
+		// Переводим диапазоны объектов в локальные координаты плоской сетки
+		for (FlatItem &item : m_items)
+		{
+			item.minX = FloorShift(item.minX, m_shift) - m_originX;
+			item.minY = FloorShift(item.minY, m_shift) - m_originY;
+			item.maxX = FloorShift(item.maxX, m_shift) - m_originX;
+			item.maxY = FloorShift(item.maxY, m_shift) - m_originY;
+		}
+
+		// === 3. Counting sort: считаем объекты в каждой ячейке ===
+		const size_t cellCount = static_cast<size_t>(m_cols) * static_cast<size_t>(m_rows);
+		m_cellStart.assign(cellCount + 1, 0);
+
+		for (const FlatItem &item : m_items)
+		{
+			for (int y = item.minY; y <= item.maxY; ++y)
+			{
+				for (int x = item.minX; x <= item.maxX; ++x)
+				{
+					++m_cellStart[CellIndex(x, y)];
+				}
+			}
+		}
+
+		// Инклюзивная префиксная сумма: m_cellStart[c] = конец ячейки c
+		uint32_t running = 0;
+		for (size_t c = 0; c < cellCount; ++c)
+		{
+			running += m_cellStart[c];
+			m_cellStart[c] = running;
+		}
+		m_cellStart[cellCount] = running;
+
+		// === 4. Раскладываем номера объектов (позиции в m_items) ===
+		// Идём с конца и уменьшаем курсор — после прохода m_cellStart[c] = начало ячейки c,
+		// а внутри ячейки объекты лежат в порядке вставки.
+		m_cellEntities.resize(running);
+		for (size_t i = m_items.size(); i-- > 0;)
+		{
+			const FlatItem &item = m_items[i];
+			for (int y = item.minY; y <= item.maxY; ++y)
+			{
+				for (int x = item.minX; x <= item.maxX; ++x)
+				{
+					m_cellEntities[--m_cellStart[CellIndex(x, y)]] = static_cast<uint32_t>(i);
+				}
+			}
+		}
+	}
+
+	// Обходит объекты в блоке 3x3 ячеек вокруг pos. Шаблонный callback инлайнится,
+	// в отличие от std::function. Объект, покрывающий несколько ячеек, может прийти несколько раз.
+	template <typename Callback>
+	void ForEachNear(const glm::vec2 &pos, Callback &&callback) const
 	{
+		if (m_mode == Mode::Flat)
+		{
+			if (m_cols == 0)
+				return;
+
+			const float flatCellSize = FlatCellSize();
+			int cx = static_cast<int>(std::floor(pos.x / flatCellSize)) - m_originX;
+			int cy = static_cast<int>(std::floor(pos.y / flatCellSize)) - m_originY;
+
+			int x0 = std::max(cx - 1, 0), x1 = std::min(cx + 1, m_cols - 1);
+			int y0 = std::max(cy - 1, 0), y1 = std::min(cy + 1, m_rows - 1);
+
+			for (int y = y0; y <= y1; ++y)
+			{
+				for (int x = x0; x <= x1; ++x)
+				{
+					size_t cell = CellIndex(x, y);
+					for (uint32_t k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k)
+					{
+						callback(static_cast<size_t>(m_items[m_cellEntities[k]].index));
+					}
+				}
+			}
+			return;
+		}
+
 		int x = static_cast<int>(std::floor(pos.x / cellSize));
 		int y = static_cast<int>(std::floor(pos.y / cellSize));
 
@@ -69,11 +240,220 @@ public:
 		}
 	}
 
+	// Обходит объекты, чьи AABB пересекают прямоугольник [minCorner, maxCorner].
+	// Каждый объект приходит ровно один раз: он сообщается только в "своей" ячейке —
+	// в левой верхней ячейке пересечения диапазонов запроса и объекта.
+	// Только для Mode::Flat (после Build()).
+	template <typename Callback>
+	void ForEachInRange(const glm::vec2 &minCorner, const glm::vec2 &maxCorner, Callback &&callback) const
+	{
+		if (m_mode != Mode::Flat || m_cols == 0)
+			return;
+
+		const float flatCellSize = FlatCellSize();
+		int qMinX = static_cast<int>(std::floor(minCorner.x / flatCellSize)) - m_originX;
+		int qMinY = static_cast<int>(std::floor(minCorner.y / flatCellSize)) - m_originY;
+		int qMaxX = static_cast<int>(std::floor(maxCorner.x / flatCellSize)) - m_originX;
+		int qMaxY = static_cast<int>(std::floor(maxCorner.y / flatCellSize)) - m_originY;
+
+		int x0 = std::max(qMinX, 0), x1 = std::min(qMaxX, m_cols - 1);
+		int y0 = std::max(qMinY, 0), y1 = std::min(qMaxY, m_rows - 1);
+
+		for (int y = y0; y <= y1; ++y)
+		{
+			for (int x = x0; x <= x1; ++x)
+			{
+				size_t cell = CellIndex(x, y);
+				for (uint32_t k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k)
+				{
+					const FlatItem &item = m_items[m_cellEntities[k]];
+
+					// Сообщаем объект только в ячейке-владельце
+					if (std::max(item.minX, x0) != x || std::max(item.minY, y0) != y)
+						continue;
+
+					if (item.maxCorner.x < minCorner.x || item.minCorner.x > maxCorner.x ||
+						item.maxCorner.y < minCorner.y || item.minCorner.y > maxCorner.y)
+						continue;
+
+					callback(static_cast<size_t>(item.index));
+				}
+			}
+		}
+	}
+
+	// Обходит объекты ячеек, через которые проходит отрезок origin + delta * t, t в [0, maxFraction],
+	// в порядке удаления от origin (DDA по ячейкам). callback(index) возвращает новое
+	// ограничение maxFraction: обход прекращается, когда следующая ячейка дальше него
+	// (как в raycast: вернул долю ближайшего попадания — дальние ячейки не смотрим).
+	// Объект, покрывающий несколько ячеек, может прийти несколько раз. Только для Mode::Flat.
+	template <typename Callback>
+	void ForEachOnRay(const glm::vec2 &origin, const glm::vec2 &delta, float maxFraction, Callback &&callback) const
+	{
+		if (m_mode != Mode::Flat || m_cols == 0)
+			return;
+
+		const float size = FlatCellSize();
+		const glm::vec2 gridMin = FlatMin();
+		const glm::vec2 gridMax = FlatMax();
+
+		// Отсекаем отрезок по границам сетки
+		float tEnter = 0.0f;
+		float tExit = maxFraction;
+		for (int axis = 0; axis < 2; ++axis)
+		{
+			if (delta[axis] == 0.0f)
+			{
+				if (origin[axis] < gridMin[axis] || origin[axis] > gridMax[axis])
+					return;
+				continue;
+			}
+
+			float t1 = (gridMin[axis] - origin[axis]) / delta[axis];
+			float t2 = (gridMax[axis] - origin[axis]) / delta[axis];
+			tEnter = std::max(tEnter, std::min(t1, t2));
+			tExit = std::min(tExit, std::max(t1, t2));
+		}
+		if (tEnter > tExit)
+			return;
+
+		const glm::vec2 start = origin + delta * tEnter;
+		int x = std::clamp(static_cast<int>(std::floor(start.x / size)) - m_originX, 0, m_cols - 1);
+		int y = std::clamp(static_cast<int>(std::floor(start.y / size)) - m_originY, 0, m_rows - 1);
+
+		const int stepX = delta.x > 0.0f ? 1 : -1;
+		const int stepY = delta.y > 0.0f ? 1 : -1;
+		const float inf = std::numeric_limits<float>::infinity();
+
+		// Доля отрезка, на которой пересекается следующая граница ячейки по каждой оси
+		float tMaxX = delta.x != 0.0f ? ((m_originX + x + (stepX > 0 ? 1 : 0)) * size - origin.x) / delta.x : inf;
+		float tMaxY = delta.y != 0.0f ? ((m_originY + y + (stepY > 0 ? 1 : 0)) * size - origin.y) / delta.y : inf;
+		const float tDeltaX = delta.x != 0.0f ? size / std::abs(delta.x) : inf;
+		const float tDeltaY = delta.y != 0.0f ? size / std::abs(delta.y) : inf;
+
+		while (true)
+		{
+			size_t cell = CellIndex(x, y);
+			for (uint32_t k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k)
+				maxFraction = std::min(maxFraction, static_cast<float>(callback(static_cast<size_t>(m_items[m_cellEntities[k]].index))));
+
+			float next;
+			if (tMaxX < tMaxY)
+			{
+				next = tMaxX;
+				x += stepX;
+				tMaxX += tDeltaX;
+			}
+			else
+			{
+				next = tMaxY;
+				y += stepY;
+				tMaxY += tDeltaY;
+			}
+
+			if (next > maxFraction || x < 0 || y < 0 || x >= m_cols || y >= m_rows)
+				return;
+		}
+	}
+
+	// Мировые границы плоской сетки (после Build()): все объекты лежат внутри
+	glm::vec2 FlatMin() const { return glm::vec2(static_cast<float>(m_originX), static_cast<float>(m_originY)) * FlatCellSize(); }
+	glm::vec2 FlatMax() const
+	{
+		return glm::vec2(static_cast<float>(m_originX + m_cols), static_cast<float>(m_originY + m_rows)) * FlatCellSize();
+	}
+	bool IsEmpty() const { return m_mode == Mode::Flat ? m_items.empty() : m_grid.empty(); }
+	float GetCellSize() const { return cellSize; }
+
+	// Обходит все пары объектов с пересекающимися AABB, каждую ровно один раз.
+	// Пара сообщается только в ячейке-владельце — левой верхней ячейке пересечения
+	// диапазонов обоих объектов, поэтому объекты больше ячейки не дают дублей.
+	// callback(a, b): a вставлен раньше b. Только для Mode::Flat (после Build()).
+	template <typename Callback>
+	void ForEachPair(Callback &&callback) const
+	{
+		ForEachPairInCells(0, CellCount(), std::forward<Callback>(callback));
+	}
+
+	// Число ячеек плоской сетки (после Build())
+	size_t CellCount() const
+	{
+		if (m_mode != Mode::Flat)
+			return 0;
+		return static_cast<size_t>(m_cols) * static_cast<size_t>(m_rows);
+	}
+
+	// То же, что ForEachPair, но только для пар, чья ячейка-владелец лежит в
+	// [cellBegin, cellEnd). Непересекающиеся диапазоны дают непересекающиеся
+	// наборы пар, поэтому сетку можно обходить из нескольких потоков.
+	template <typename Callback>
+	void ForEachPairInCells(size_t cellBegin, size_t cellEnd, Callback &&callback) const
+	{
+		if (m_mode != Mode::Flat)
+			return;
+
+		cellEnd = std::min(cellEnd, CellCount());
+		for (size_t cell = cellBegin; cell < cellEnd; ++cell)
+		{
+			const int x = static_cast<int>(cell % static_cast<size_t>(m_cols));
+			const int y = static_cast<int>(cell / static_cast<size_t>(m_cols));
+			const uint32_t begin = m_cellStart[cell];
+			const uint32_t end = m_cellStart[cell + 1];
+
+			for (uint32_t ka = begin; ka < end; ++ka)
+			{
+				const FlatItem &a = m_items[m_cellEntities[ka]];
+				for (uint32_t kb = ka + 1; kb < end; ++kb)
+				{
+					const FlatItem &b = m_items[m_cellEntities[kb]];
+
+					if (std::max(a.minX, b.minX) != x || std::max(a.minY, b.minY) != y)
+						continue;
+
+					if (a.maxCorner.x < b.minCorner.x || a.minCorner.x > b.maxCorner.x ||
+						a.maxCorner.y < b.minCorner.y || a.minCorner.y > b.maxCorner.y)
+						continue;
+
+					callback(static_cast<size_t>(a.index), static_cast<size_t>(b.index));
+				}
+			}
+		}
+	}
+
 	// const std::unordered_map<size_t, Cell> &getGrid() const { return grid; }
 	// float getCellSize() const { return cellSize; }
 
 	void printStats() const
 	{
+		if (m_mode == Mode::Flat)
+		{
+			size_t cellCount = static_cast<size_t>(m_cols) * static_cast<size_t>(m_rows);
+			size_t nonEmpty = 0;
+			uint32_t maxEntities = 0;
+			for (size_t c = 0; c < cellCount; ++c)
+			{
+				uint32_t count = m_cellStart[c + 1] - m_cellStart[c];
+				if (count > 0)
+					++nonEmpty;
+				maxEntities = std::max(maxEntities, count);
+			}
+
+			if (nonEmpty == 0)
+			{
+				std::cout << "[SpatialHash] Пусто\n";
+				return;
+			}
+
+			std::cout << "[SpatialHash:Flat] "
+					  << "Ячеек всего: " << cellCount
+					  << ", Непустых: " << nonEmpty
+					  << ", Объектов: " << m_cellEntities.size()
+					  << ", Среднее: " << static_cast<double>(m_cellEntities.size()) / nonEmpty
+					  << ", Макс: " << maxEntities
+					  << ", Размер ячейки: " << FlatCellSize() << "\n";
+			return;
+		}
+
 		if (m_grid.empty())
 		{
 			std::cout << "[SpatialHash] Пусто\n";
@@ -115,7 +495,7 @@ public:
 	{
 		clearConsole();
 
-		if (m_grid.empty())
+		if (m_mode == Mode::Flat ? m_cellEntities.empty() : m_grid.empty())
 		{
 			std::cout << "[SpatialHash] Сетка пуста\n";
 			return;
@@ -163,14 +543,8 @@ public:
 			{
 				int cellX = cellLeft + c;
 				int cellY = cellTop + r;
-				size_t key = (static_cast<size_t>(cellX) << 16) ^ static_cast<size_t>(cellY);
 
-				int count = 0;
-				auto it = m_grid.find(key);
-				if (it != m_grid.end())
-				{
-					count = static_cast<int>(it->second.entities.size());
-				}
+				int count = static_cast<int>(CellPopulation(cellX, cellY));
 
 				if (count == 0)
 				{
@@ -193,6 +567,58 @@ public:
 	}
 
 private:
+	// Сколько объектов в ячейке (координаты в ячейках cellSize)
+	size_t CellPopulation(int cellX, int cellY) const
+	{
+		if (m_mode == Mode::Flat)
+		{
+			int x = FloorShift(cellX, m_shift) - m_originX;
+			int y = FloorShift(cellY, m_shift) - m_originY;
+			if (x < 0 || y < 0 || x >= m_cols || y >= m_rows)
+				return 0;
+
+			size_t cell = CellIndex(x, y);
+			return m_cellStart[cell + 1] - m_cellStart[cell];
+		}
+
+		size_t key = (static_cast<size_t>(cellX) << 16) ^ static_cast<size_t>(cellY);
+		auto it = m_grid.find(key);
+		return it != m_grid.end() ? it->second.entities.size() : 0;
+	}
+
+	// Деление на 2^shift с округлением вниз (корректно и для отрицательных)
+	static int FloorShift(int value, int shift)
+	{
+		return value >= 0 ? (value >> shift) : -((-value + (1 << shift) - 1) >> shift);
+	}
+
+	size_t CellIndex(int x, int y) const
+	{
+		return static_cast<size_t>(y) * static_cast<size_t>(m_cols) + static_cast<size_t>(x);
+	}
+
+	float FlatCellSize() const { return cellSize * static_cast<float>(1 << m_shift); }
+
+	// Объект flat-сетки: индекс, диапазон ячеек, которые он покрывает, и его AABB
+	struct FlatItem
+	{
+		uint32_t index;
+		int minX, minY, maxX, maxY;
+		glm::vec2 minCorner, maxCorner;
+	};
+
+	static constexpr int64_t k_minFlatCells = 1024;	 // нижняя граница лимита ячеек
+	static constexpr int64_t k_flatCellsPerItem = 16; // лимит ячеек на один объект
+
 	float cellSize;
+	Mode m_mode;
 	std::unordered_map<size_t, Cell> m_grid;
+
+	// === Flat-режим ===
+	std::vector<FlatItem> m_items;		   // объекты, вставленные в этом кадре
+	std::vector<uint32_t> m_cellStart{0};  // начало каждой ячейки в m_cellEntities (+ конец)
+	std::vector<uint32_t> m_cellEntities;  // номера объектов в m_items, сгруппированные по ячейкам
+	int m_originX = 0, m_originY = 0;	   // координата левой верхней ячейки
+	int m_cols = 0, m_rows = 0;			   // размер плоской сетки
+	int m_shift = 0;					   // укрупнение ячеек: cellSize * 2^shift
 };
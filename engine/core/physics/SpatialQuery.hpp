@@ -0,0 +1,33 @@
+// engine/core/physics/SpatialQuery.hpp
+#pragma once
+#include <cstdint>
+#include <glm/vec2.hpp>
+
+#include <extern/entt/entt.hpp>
+
+namespace le
+{
+
+	// Какие тела видит пространственный запрос PhysicsSystem
+	struct QueryFilter
+	{
+		uint32_t maskBits = 0xFFFFFFFF; // слои (categoryBits), которые видит запрос
+		bool includeTriggers = false;
+		entt::entity ignore = entt::null; // например, сам стреляющий
+	};
+
+	struct RaycastHit
+	{
+		entt::entity entity = entt::null; // entt::null — промах
+		glm::vec2 point{0.0f};
+		glm::vec2 normal{0.0f};
+		float fraction = 1.0f; // доля отрезка from -> to до точки попадания
+	};
+
+	struct Ray
+	{
+		glm::vec2 from;
+		glm::vec2 to;
+	};
+
+} // namespace le
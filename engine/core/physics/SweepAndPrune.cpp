@@ -0,0 +1,102 @@
+// engine/core/physics/SweepAndPrune.cpp
+#include "SweepAndPrune.hpp"
+
+namespace le
+{
+
+	void SweepAndPrune::BeginUpdate(size_t idCount)
+	{
+		++m_frame;
+
+		m_boxes.resize(idCount);
+		m_stamps.resize(idCount, 0);
+		m_inOrder.resize(idCount, 0);
+	}
+
+	void SweepAndPrune::SetBox(uint32_t id, const glm::vec2 &minCorner, const glm::vec2 &maxCorner)
+	{
+		m_boxes[id] = {minCorner, maxCorner};
+		m_stamps[id] = m_frame;
+	}
+
+	void SweepAndPrune::EndUpdate()
+	{
+		const size_t idCount = m_boxes.size();
+
+		// Убираем прокси, которые в этом кадре не обновлялись (или чей id больше не существует)
+		size_t kept = 0;
+		for (uint32_t id : m_order)
+		{
+			if (id < idCount && m_stamps[id] == m_frame)
+				m_order[kept++] = id;
+			else if (id < idCount)
+				m_inOrder[id] = 0;
+		}
+		m_order.resize(kept);
+
+		// Сортировка вставками: порядок прошлого кадра почти верный
+		for (size_t k = 1; k < m_order.size(); ++k)
+		{
+			uint32_t id = m_order[k];
+			size_t q = k;
+			while (q > 0 && Less(id, m_order[q - 1]))
+			{
+				m_order[q] = m_order[q - 1];
+				--q;
+			}
+			m_order[q] = id;
+		}
+
+		// Новые прокси сортируются отдельно и вливаются слиянием — вставками их было бы O(n^2)
+		m_added.clear();
+		for (uint32_t id = 0; id < idCount; ++id)
+		{
+			if (m_stamps[id] == m_frame && !m_inOrder[id])
+			{
+				m_added.push_back(id);
+				m_inOrder[id] = 1;
+			}
+		}
+
+		if (!m_added.empty())
+		{
+			auto less = [this](uint32_t lhs, uint32_t rhs)
+			{ return Less(lhs, rhs); };
+
+			std::sort(m_added.begin(), m_added.end(), less);
+			size_t middle = m_order.size();
+			m_order.insert(m_order.end(), m_added.begin(), m_added.end());
+			std::inplace_merge(m_order.begin(), m_order.begin() + middle, m_order.end(), less);
+		}
+
+		const size_t count = m_order.size();
+		m_sortedIds.assign(m_order.begin(), m_order.end());
+		m_sortedMinX.resize(count);
+		m_sortedMaxX.resize(count);
+		m_sortedMinY.resize(count);
+		m_sortedMaxY.resize(count);
+		for (size_t k = 0; k < count; ++k)
+		{
+			const Box &box = m_boxes[m_order[k]];
+			m_sortedMinX[k] = box.minCorner.x;
+			m_sortedMaxX[k] = box.maxCorner.x;
+			m_sortedMinY[k] = box.minCorner.y;
+			m_sortedMaxY[k] = box.maxCorner.y;
+		}
+	}
+
+	void SweepAndPrune::Clear()
+	{
+		m_boxes.clear();
+		m_stamps.clear();
+		m_inOrder.clear();
+		m_order.clear();
+		m_added.clear();
+		m_sortedIds.clear();
+		m_sortedMinX.clear();
+		m_sortedMaxX.clear();
+		m_sortedMinY.clear();
+		m_sortedMaxY.clear();
+	}
+
+} // namespace le
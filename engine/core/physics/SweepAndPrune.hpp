@@ -0,0 +1,93 @@
+// engine/core/physics/SweepAndPrune.hpp
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+
+namespace le
+{
+
+	/**
+	 * @brief Broadphase sort-and-sweep по оси X.
+	 *
+	 * Прокси (по id, например слоту тела) отсортированы по левой границе, и этот
+	 * порядок живёт между кадрами: при согласованном движении тела сдвигаются
+	 * в нём на пару позиций, и сортировка вставками почти ничего не делает.
+	 * Размер объектов не важен — в отличие от сетки с фиксированной ячейкой.
+	 *
+	 * Кадр: BeginUpdate → SetBox для всех живых прокси → EndUpdate → ForEachPair.
+	 * Прокси, не получившие SetBox в этом кадре, удаляются.
+	 */
+	class SweepAndPrune
+	{
+	public:
+		// idCount — верхняя граница id в этом кадре
+		void BeginUpdate(size_t idCount);
+		void SetBox(uint32_t id, const glm::vec2 &minCorner, const glm::vec2 &maxCorner);
+		void EndUpdate();
+		void Clear();
+
+		size_t ProxyCount() const { return m_sortedIds.size(); }
+
+		// Все пары с пересекающимися AABB (касание считается), каждая один раз.
+		// callback(a, b): a < b.
+		template <typename Callback>
+		void ForEachPair(Callback &&callback) const
+		{
+			ForEachPairInRange(0, ProxyCount(), std::forward<Callback>(callback));
+		}
+
+		// Пары, у которых левый по X прокси стоит в отсортированном порядке на [begin, end).
+		// Непересекающиеся диапазоны дают непересекающиеся наборы пар — можно обходить из нескольких потоков.
+		template <typename Callback>
+		void ForEachPairInRange(size_t begin, size_t end, Callback &&callback) const
+		{
+			const size_t count = m_sortedIds.size();
+			end = std::min(end, count);
+
+			for (size_t k = begin; k < end; ++k)
+			{
+				const float maxX = m_sortedMaxX[k];
+				const float minY = m_sortedMinY[k];
+				const float maxY = m_sortedMaxY[k];
+
+				for (size_t q = k + 1; q < count && m_sortedMinX[q] <= maxX; ++q)
+				{
+					if (maxY < m_sortedMinY[q] || minY > m_sortedMaxY[q])
+						continue;
+
+					uint32_t a = m_sortedIds[k];
+					uint32_t b = m_sortedIds[q];
+					callback(static_cast<size_t>(std::min(a, b)), static_cast<size_t>(std::max(a, b)));
+				}
+			}
+		}
+
+	private:
+		struct Box
+		{
+			glm::vec2 minCorner;
+			glm::vec2 maxCorner;
+		};
+
+		bool Less(uint32_t lhs, uint32_t rhs) const
+		{
+			float l = m_boxes[lhs].minCorner.x;
+			float r = m_boxes[rhs].minCorner.x;
+			return l < r || (l == r && lhs < rhs);
+		}
+
+		std::vector<Box> m_boxes;		// по id
+		std::vector<uint32_t> m_stamps; // кадр последнего SetBox
+		std::vector<uint8_t> m_inOrder; // id уже есть в m_order
+		std::vector<uint32_t> m_order;	// id по возрастанию minX — сохраняется между кадрами
+		std::vector<uint32_t> m_added;	// новые id кадра
+		uint32_t m_frame = 0;
+
+		// Отсортированная копия границ (SoA) — sweep идёт по непрерывной памяти
+		std::vector<uint32_t> m_sortedIds;
+		std::vector<float> m_sortedMinX, m_sortedMaxX, m_sortedMinY, m_sortedMaxY;
+	};
+
+} // namespace le
@@ -0,0 +1,235 @@
+// engine/core/physics/TileCollisionMap.cpp
+#include "TileCollisionMap.hpp"
+
+#include <algorithm>
+
+#include <engine/core/ecs/components/CoreComponents.hpp>
+#include <engine/core/ecs/components/PhysicsComponents.hpp>
+
+namespace le
+{
+
+	TileCollisionMap::TileCollisionMap(int width, int height) : TileCollisionMap(width, height, Settings{}) {}
+
+	TileCollisionMap::TileCollisionMap(int width, int height, const Settings &settings)
+		: m_width(std::max(width, 0)), m_height(std::max(height, 0)), m_settings(settings)
+	{
+		m_settings.chunkSize = std::max(m_settings.chunkSize, 1);
+		m_chunkCols = (m_width + m_settings.chunkSize - 1) / m_settings.chunkSize;
+		m_chunkRows = (m_height + m_settings.chunkSize - 1) / m_settings.chunkSize;
+
+		m_solid.assign(static_cast<size_t>(m_width) * m_height, 0);
+		m_chunks.resize(static_cast<size_t>(m_chunkCols) * m_chunkRows);
+		for (uint32_t c = 0; c < m_chunks.size(); ++c)
+			m_dirtyChunks.push_back(c);
+	}
+
+	void TileCollisionMap::SetTiles(const uint8_t *solid)
+	{
+		m_solidCount = 0;
+		for (size_t k = 0; k < m_solid.size(); ++k)
+		{
+			m_solid[k] = solid[k] != 0;
+			m_solidCount += m_solid[k];
+		}
+
+		m_dirtyChunks.clear();
+		for (uint32_t c = 0; c < m_chunks.size(); ++c)
+		{
+			m_chunks[c].dirty = true;
+			m_dirtyChunks.push_back(c);
+		}
+	}
+
+	void TileCollisionMap::SetSolid(int x, int y, bool solid)
+	{
+		if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+			return;
+
+		uint8_t &tile = m_solid[static_cast<size_t>(y) * m_width + x];
+		if (tile == static_cast<uint8_t>(solid))
+			return;
+
+		tile = solid;
+		m_solidCount += solid ? 1 : -1;
+		MarkDirty(x, y);
+	}
+
+	bool TileCollisionMap::IsSolid(int x, int y) const
+	{
+		if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+			return false;
+		return m_solid[static_cast<size_t>(y) * m_width + x] != 0;
+	}
+
+	void TileCollisionMap::MarkDirty(int x, int y)
+	{
+		const uint32_t c = static_cast<uint32_t>((y / m_settings.chunkSize) * m_chunkCols + x / m_settings.chunkSize);
+		if (m_chunks[c].dirty)
+			return;
+
+		m_chunks[c].dirty = true;
+		m_dirtyChunks.push_back(c);
+	}
+
+	void TileCollisionMap::Rebuild(entt::registry &registry)
+	{
+		// По возрастанию — сущности создаются в одном и том же порядке при любом порядке правок
+		std::sort(m_dirtyChunks.begin(), m_dirtyChunks.end());
+		for (uint32_t c : m_dirtyChunks)
+		{
+			RebuildChunk(registry, m_chunks[c], static_cast<int>(c % m_chunkCols), static_cast<int>(c / m_chunkCols));
+			m_chunks[c].dirty = false;
+		}
+		m_dirtyChunks.clear();
+	}
+
+	void TileCollisionMap::Clear(entt::registry &registry)
+	{
+		m_dirtyChunks.clear();
+		for (uint32_t c = 0; c < m_chunks.size(); ++c)
+		{
+			Chunk &chunk = m_chunks[c];
+			for (entt::entity body : chunk.bodies)
+			{
+				if (registry.valid(body))
+					registry.destroy(body);
+			}
+			chunk.rects.clear();
+			chunk.bodies.clear();
+			chunk.dirty = true;
+			m_dirtyChunks.push_back(c);
+		}
+		m_bodyCount = 0;
+	}
+
+	void TileCollisionMap::RebuildChunk(entt::registry &registry, Chunk &chunk, int chunkX, int chunkY)
+	{
+		const int size = m_settings.chunkSize;
+		const int x0 = chunkX * size;
+		const int y0 = chunkY * size;
+
+		m_newRects.clear();
+		MergeRects(m_solid.data(), m_width, x0, y0, std::min(size, m_width - x0), std::min(size, m_height - y0),
+				   m_newRects, m_claimed);
+
+		// === 1. Совпавшие прямоугольники сохраняют сущности ===
+		// Оба списка идут по (y, x) левого верхнего угла — сопоставляем одним проходом
+		m_newBodies.assign(m_newRects.size(), entt::null);
+		m_freeBodies.clear();
+
+		size_t k = 0;
+		for (size_t old = 0; old < chunk.rects.size(); ++old)
+		{
+			const Rect &rect = chunk.rects[old];
+			while (k < m_newRects.size() &&
+				   (m_newRects[k].y < rect.y || (m_newRects[k].y == rect.y && m_newRects[k].x < rect.x)))
+				++k;
+
+			const entt::entity body = chunk.bodies[old];
+			if (!registry.valid(body))
+				continue;
+
+			if (k < m_newRects.size() && m_newRects[k] == rect)
+				m_newBodies[k] = body;
+			else
+				m_freeBodies.push_back(body);
+		}
+
+		// === 2. Новые прямоугольники забирают освободившиеся сущности или создают свои ===
+		for (size_t n = 0; n < m_newRects.size(); ++n)
+		{
+			if (m_newBodies[n] != entt::null)
+				continue;
+
+			if (!m_freeBodies.empty())
+			{
+				m_newBodies[n] = m_freeBodies.back();
+				m_freeBodies.pop_back();
+				ApplyRect(registry, m_newBodies[n], m_newRects[n], false);
+			}
+			else
+			{
+				m_newBodies[n] = registry.create();
+				ApplyRect(registry, m_newBodies[n], m_newRects[n], true);
+			}
+		}
+
+		for (entt::entity body : m_freeBodies)
+			registry.destroy(body);
+
+		m_bodyCount -= chunk.bodies.size();
+		m_bodyCount += m_newBodies.size();
+		chunk.rects.swap(m_newRects);
+		chunk.bodies.swap(m_newBodies);
+	}
+
+	void TileCollisionMap::ApplyRect(entt::registry &registry, entt::entity entity, const Rect &rect, bool created) const
+	{
+		const float tileSize = m_settings.tileSize;
+		const glm::vec2 size(rect.width * tileSize, rect.height * tileSize);
+		const glm::vec2 center = m_settings.origin + glm::vec2(rect.x * tileSize, rect.y * tileSize) + size * 0.5f;
+
+		if (created)
+		{
+			registry.emplace<Transform>(entity).position = center;
+			registry.emplace<Rigidbody2D>(entity, 0.0f, m_settings.restitution, m_settings.friction);
+
+			auto &collider = registry.emplace<BoxCollider2D>(entity);
+			collider.size = size;
+			collider.categoryBits = m_settings.categoryBits;
+			collider.maskBits = m_settings.maskBits;
+			return;
+		}
+
+		// Позицию физика читает каждый кадр, размер — только после patch
+		registry.get<Transform>(entity).position = center;
+		registry.patch<BoxCollider2D>(entity, [&](BoxCollider2D &collider)
+									  { collider.size = size; });
+	}
+
+	void TileCollisionMap::MergeRects(const uint8_t *solid, int stride, int x0, int y0, int width, int height,
+									  std::vector<Rect> &out, std::vector<uint8_t> &claimed)
+	{
+		if (width <= 0 || height <= 0)
+			return;
+
+		claimed.assign(static_cast<size_t>(width) * height, 0);
+		auto isFree = [&](int x, int y)
+		{
+			return solid[static_cast<size_t>(y0 + y) * stride + x0 + x] != 0 && !claimed[static_cast<size_t>(y) * width + x];
+		};
+
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				if (!isFree(x, y))
+					continue;
+
+				// Полоса вправо
+				int right = x + 1;
+				while (right < width && isFree(right, y))
+					++right;
+
+				// Вниз, пока свободна вся полоса
+				int bottom = y + 1;
+				for (; bottom < height; ++bottom)
+				{
+					bool rowFree = true;
+					for (int column = x; column < right && rowFree; ++column)
+						rowFree = isFree(column, bottom);
+					if (!rowFree)
+						break;
+				}
+
+				for (int row = y; row < bottom; ++row)
+					std::fill_n(claimed.begin() + static_cast<size_t>(row) * width + x, right - x, uint8_t(1));
+
+				out.push_back({x0 + x, y0 + y, right - x, bottom - y});
+				x = right - 1;
+			}
+		}
+	}
+
+} // namespace le
@@ -0,0 +1,129 @@
+// engine/core/physics/TileCollisionMap.hpp
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+
+#include <extern/entt/entt.hpp>
+
+namespace le
+{
+
+	/**
+	 * @brief Статические коллайдеры тайловой карты, слитые в прямоугольники.
+	 *
+	 * Вместо BoxCollider2D на каждый твёрдый тайл карта жадно сливает их в как можно
+	 * меньше прямоугольников: полоса вправо, пока тайлы твёрдые, затем вниз, пока
+	 * твёрдая вся полоса. Каждый прямоугольник — одна статическая сущность
+	 * (Transform + Rigidbody2D с массой 0 + BoxCollider2D). Тел в десятки–сотни раз меньше,
+	 * а внутренних рёбер, о которые цепляются тела, нет.
+	 *
+	 * Карта поделена на чанки chunkSize × chunkSize тайлов, прямоугольники не выходят
+	 * за чанк: SetSolid пересобирает только свой чанк, а одинаковые прямоугольники
+	 * сохраняют свои сущности (разбиение статики в PhysicsSystem при этом пересобирается
+	 * один раз). Швы остаются лишь на границах чанков.
+	 *
+	 * Кадр: SetTiles / SetSolid сколько угодно → Rebuild(registry) перед Update физики.
+	 */
+	class TileCollisionMap
+	{
+	public:
+		// Прямоугольник в тайлах
+		struct Rect
+		{
+			int x, y;
+			int width, height;
+
+			bool operator==(const Rect &other) const
+			{
+				return x == other.x && y == other.y && width == other.width && height == other.height;
+			}
+		};
+
+		struct Settings
+		{
+			float tileSize = 32.0f;
+			glm::vec2 origin{0.0f, 0.0f}; // мировая позиция левого верхнего угла тайла (0, 0)
+			int chunkSize = 64;			  // сторона чанка в тайлах
+			float restitution = 0.0f;
+			float friction = 0.5f;
+			uint32_t categoryBits = 0x0001;
+			uint32_t maskBits = 0xFFFFFFFF;
+		};
+
+		TileCollisionMap(int width, int height);
+		TileCollisionMap(int width, int height, const Settings &settings);
+
+		// Сущности не удаляются: реестр может умереть раньше карты — для этого есть Clear()
+		~TileCollisionMap() = default;
+
+		int GetWidth() const { return m_width; }
+		int GetHeight() const { return m_height; }
+		const Settings &GetSettings() const { return m_settings; }
+
+		// Вся карта сразу: width * height байт по строкам, ненулевой — твёрдый тайл
+		void SetTiles(const uint8_t *solid);
+		// Тайл за пределами карты игнорируется
+		void SetSolid(int x, int y, bool solid);
+		bool IsSolid(int x, int y) const;
+
+		// Пересобирает прямоугольники изменённых чанков и приводит к ним сущности
+		void Rebuild(entt::registry &registry);
+		// Удаляет все сущности карты (тайлы остаются — следующий Rebuild создаст их заново)
+		void Clear(entt::registry &registry);
+
+		size_t BodyCount() const { return m_bodyCount; }
+		size_t SolidTileCount() const { return m_solidCount; }
+
+		// Прямоугольники, на которые разбит чанк (в тайлах карты)
+		const std::vector<Rect> &GetChunkRects(int chunkX, int chunkY) const
+		{
+			return m_chunks[static_cast<size_t>(chunkY) * m_chunkCols + chunkX].rects;
+		}
+		int GetChunkCols() const { return m_chunkCols; }
+		int GetChunkRows() const { return m_chunkRows; }
+
+		/**
+		 * @brief Жадное слияние твёрдых тайлов области в прямоугольники.
+		 *
+		 * @param solid — тайлы по строкам, stride — длина строки
+		 * @param x0, y0, width, height — область в тайлах
+		 * @param out — [out] прямоугольники добавляются в конец, по строкам сверху вниз
+		 * @param claimed — рабочий буфер (переиспользуется между вызовами)
+		 */
+		static void MergeRects(const uint8_t *solid, int stride, int x0, int y0, int width, int height,
+							   std::vector<Rect> &out, std::vector<uint8_t> &claimed);
+
+	private:
+		struct Chunk
+		{
+			std::vector<Rect> rects;
+			std::vector<entt::entity> bodies; // bodies[k] — сущность rects[k]
+			bool dirty = true;
+		};
+
+		void MarkDirty(int x, int y);
+		void RebuildChunk(entt::registry &registry, Chunk &chunk, int chunkX, int chunkY);
+		// Записывает прямоугольник в компоненты сущности
+		void ApplyRect(entt::registry &registry, entt::entity entity, const Rect &rect, bool created) const;
+
+		int m_width;
+		int m_height;
+		Settings m_settings;
+		int m_chunkCols;
+		int m_chunkRows;
+
+		std::vector<uint8_t> m_solid; // по строкам, 0/1
+		std::vector<Chunk> m_chunks;
+		std::vector<uint32_t> m_dirtyChunks; // номера чанков с dirty = true
+		size_t m_bodyCount = 0;
+		size_t m_solidCount = 0;
+
+		// Буферы Rebuild — переиспользуются
+		std::vector<Rect> m_newRects;
+		std::vector<uint8_t> m_claimed;
+		std::vector<entt::entity> m_newBodies;
+		std::vector<entt::entity> m_freeBodies; // сущности исчезнувших прямоугольников
+	};
+
+} // namespace le
@@ -0,0 +1,45 @@
+#include <engine/core/utils/Clock.hpp>
+#include <algorithm>
+#include <cmath>
+
+void utils::Clock::Advance(float deltaTime)
+{
+	m_deltaTime = std::max(deltaTime, 0.0f);
+	m_elapsedTime += m_deltaTime;
+	++m_frameCount;
+}
+
+void utils::Clock::SetFixedDeltaTime(float fixedDeltaTime)
+{
+	if (fixedDeltaTime > 0.0f)
+		m_fixedDeltaTime = fixedDeltaTime;
+}
+
+void utils::Clock::SetMaxFixedSteps(int maxSteps)
+{
+	m_maxFixedSteps = std::max(maxSteps, 1);
+}
+
+int utils::Clock::ConsumeFixedSteps()
+{
+	m_accumulator += m_deltaTime;
+
+	int steps = static_cast<int>(m_accumulator / m_fixedDeltaTime);
+	if (steps > m_maxFixedSteps)
+	{
+		// Не успеваем — симуляция замедляется, но кадр остаётся предсказуемым
+		steps = m_maxFixedSteps;
+		m_accumulator = std::fmod(m_accumulator, m_fixedDeltaTime);
+	}
+	else
+	{
+		m_accumulator -= static_cast<float>(steps) * m_fixedDeltaTime;
+	}
+
+	return steps;
+}
+
+float utils::Clock::InterpolationAlpha() const
+{
+	return std::clamp(m_accumulator / m_fixedDeltaTime, 0.0f, 1.0f);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+namespace utils
+{
+	/**
+	 * @brief Время одного мира: длительность кадра и накопитель фиксированных шагов.
+	 *
+	 * В отличие от utils::Time не читает системные часы — кадр задаёт Advance(dt).
+	 * Так у каждого мира (le::World) своё время: выделенный сервер шагает матчи
+	 * по своему расписанию, окно — по utils::Time::DeltaTime().
+	 */
+	class Clock
+	{
+	public:
+		// Начинает кадр длительностью deltaTime секунд
+		void Advance(float deltaTime);
+		float DeltaTime() const { return m_deltaTime; }
+		// Сумма всех кадров с создания
+		double ElapsedTime() const { return m_elapsedTime; }
+		uint64_t FrameCount() const { return m_frameCount; }
+
+		// ! Фиксированный шаг симуляции (физика, FixedUpdate)
+		void SetFixedDeltaTime(float fixedDeltaTime);
+		float FixedDeltaTime() const { return m_fixedDeltaTime; }
+		// Сколько шагов максимум наверстать за кадр. Остальное время отбрасывается,
+		// чтобы длинный кадр не запускал лавину шагов.
+		void SetMaxFixedSteps(int maxSteps);
+		int MaxFixedSteps() const { return m_maxFixedSteps; }
+
+		// Добавляет DeltaTime в накопитель и возвращает число фиксированных шагов в этом кадре
+		int ConsumeFixedSteps();
+		// Доля шага [0, 1), накопленная сверх последнего шага, — для интерполяции отрисовки
+		float InterpolationAlpha() const;
+
+	private:
+		float m_deltaTime = 0.0f;
+		double m_elapsedTime = 0.0;
+		uint64_t m_frameCount = 0;
+
+		float m_fixedDeltaTime = 1.0f / 60.0f;
+		int m_maxFixedSteps = 5;
+		float m_accumulator = 0.0f;
+	};
+}
@@ -5,6 +5,7 @@ namespace fs = std::filesystem;
 namespace utils
 {
 	std::ofstream Logger::logFile;
+	std::mutex Logger::logMutex;
 
 	std::string Logger::generateLogFilename(const std::string &logDir)
 	{
@@ -45,6 +46,8 @@ namespace utils
 
 	void Logger::log(LogLevel level, const std::string &message)
 	{
+		std::lock_guard<std::mutex> lock(logMutex);
+
 		std::time_t now = std::time(nullptr);
 		char timestamp[20];
 		std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
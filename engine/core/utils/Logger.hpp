@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 
 namespace utils
 {
@@ -30,6 +31,8 @@ namespace utils
 
 	private:
 		static std::ofstream logFile;
+		// Пишут из нескольких потоков (миры шагают параллельно)
+		static std::mutex logMutex;
 		static std::string generateLogFilename(const std::string &logDir);
 
 		static void log(LogLevel level, const std::string &message);
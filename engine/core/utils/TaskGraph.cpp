@@ -0,0 +1,171 @@
+#include <engine/core/utils/TaskGraph.hpp>
+
+namespace utils
+{
+	TaskGraph::TaskBuilder &TaskGraph::TaskBuilder::Read(Resource resource)
+	{
+		m_graph.m_tasks[m_task].access.emplace_back(resource, false);
+		m_graph.m_built = false;
+		return *this;
+	}
+
+	TaskGraph::TaskBuilder &TaskGraph::TaskBuilder::Write(Resource resource)
+	{
+		m_graph.m_tasks[m_task].access.emplace_back(resource, true);
+		m_graph.m_built = false;
+		return *this;
+	}
+
+	TaskGraph::TaskBuilder &TaskGraph::TaskBuilder::Exclusive()
+	{
+		m_graph.m_tasks[m_task].exclusive = true;
+		m_graph.m_built = false;
+		return *this;
+	}
+
+	TaskGraph::TaskBuilder &TaskGraph::TaskBuilder::MainThread()
+	{
+		m_graph.m_tasks[m_task].mainThread = true;
+		return *this;
+	}
+
+	TaskGraph::TaskBuilder TaskGraph::Add(std::string name, std::function<void()> function)
+	{
+		Task &task = m_tasks.emplace_back();
+		task.name = std::move(name);
+		task.function = std::move(function);
+		task.batch = std::make_unique<ThreadPool::Batch>();
+		m_built = false;
+		return TaskBuilder(*this, m_tasks.size() - 1);
+	}
+
+	void TaskGraph::Clear()
+	{
+		m_tasks.clear();
+		m_built = false;
+	}
+
+	void TaskGraph::Build()
+	{
+		// Рёбра — по объявленным ресурсам; flow сам убирает транзитивные.
+		// Все задачи читают общий служебный ресурс, а Exclusive его пишет — так она
+		// отделяет и задачи, не объявившие ничего.
+		constexpr Resource k_everything = entt::hashed_string::value("utils::TaskGraph::Exclusive");
+
+		entt::flow flow;
+		for (size_t i = 0; i < m_tasks.size(); ++i)
+		{
+			Task &task = m_tasks[i];
+			flow.bind(static_cast<entt::id_type>(i));
+			flow.set(k_everything, task.exclusive);
+			for (const auto &[resource, write] : task.access)
+				flow.set(resource, write);
+
+			task.dependencies.clear();
+			task.successors.clear();
+
+			const uint32_t index = static_cast<uint32_t>(i);
+			task.runner = [this, index](size_t)
+			{
+				m_tasks[index].function();
+				OnTaskDone(index);
+			};
+		}
+
+		const auto graph = flow.graph();
+		for (auto [from, to] : graph.edges())
+		{
+			m_tasks[to].dependencies.push_back(static_cast<uint32_t>(from));
+			m_tasks[from].successors.push_back(static_cast<uint32_t>(to));
+		}
+
+		m_remaining = std::make_unique<std::atomic<uint32_t>[]>(m_tasks.size());
+		m_built = true;
+	}
+
+	void TaskGraph::Execute(ThreadPool &pool)
+	{
+		if (!m_built)
+			Build();
+		if (m_tasks.empty())
+			return;
+
+		// Один поток — порядок объявления уже согласован со всеми зависимостями
+		if (pool.WorkerCount() == 1)
+		{
+			for (Task &task : m_tasks)
+				task.function();
+			return;
+		}
+
+		m_pool = &pool;
+		m_completed.store(0, std::memory_order_relaxed);
+		m_mainQueue.clear();
+		for (size_t i = 0; i < m_tasks.size(); ++i)
+			m_remaining[i].store(static_cast<uint32_t>(m_tasks[i].dependencies.size()), std::memory_order_relaxed);
+
+		for (size_t i = 0; i < m_tasks.size(); ++i)
+		{
+			if (m_tasks[i].dependencies.empty())
+				Schedule(static_cast<uint32_t>(i));
+		}
+
+		// Пока граф не закончен — свои задачи главного потока, иначе помогаем пулу
+		while (m_completed.load(std::memory_order_acquire) < m_tasks.size())
+		{
+			if (RunMainThreadTask() || pool.RunPendingTask())
+				continue;
+			std::this_thread::yield();
+		}
+
+		// Последняя задача могла отчитаться, а её поток ещё не отпустил пачку
+		for (Task &task : m_tasks)
+		{
+			if (task.mainThread)
+				continue;
+			while (!task.batch->IsFinished())
+				std::this_thread::yield();
+		}
+		m_pool = nullptr;
+	}
+
+	void TaskGraph::Schedule(uint32_t task)
+	{
+		Task &entry = m_tasks[task];
+		if (entry.mainThread)
+		{
+			std::lock_guard<std::mutex> lock(m_mainMutex);
+			m_mainQueue.push_back(task);
+			return;
+		}
+
+		entry.batch->Reset(&entry.runner, 1);
+		m_pool->Submit(*entry.batch);
+	}
+
+	void TaskGraph::OnTaskDone(uint32_t task)
+	{
+		for (uint32_t successor : m_tasks[task].successors)
+		{
+			if (m_remaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+				Schedule(successor);
+		}
+		m_completed.fetch_add(1, std::memory_order_release);
+	}
+
+	bool TaskGraph::RunMainThreadTask()
+	{
+		uint32_t task;
+		{
+			std::lock_guard<std::mutex> lock(m_mainMutex);
+			if (m_mainQueue.empty())
+				return false;
+			// В порядке готовности
+			task = m_mainQueue.front();
+			m_mainQueue.erase(m_mainQueue.begin());
+		}
+
+		m_tasks[task].runner(0);
+		return true;
+	}
+}
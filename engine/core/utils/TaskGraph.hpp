@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <extern/entt/entt.hpp>
+
+#include <engine/core/utils/ThreadPool.hpp>
+
+namespace utils
+{
+	/**
+	 * @brief Граф задач кадра поверх ThreadPool.
+	 *
+	 * Задача объявляет, какие ресурсы читает и пишет: типы компонентов, системы,
+	 * синглтоны (Read<Transform>(), Write<Renderer>()). Build() связывает задачи через
+	 * entt::flow: кто пишет ресурс, ждёт всех, кто трогал его раньше (в порядке Add),
+	 * читатели одного ресурса друг друга не ждут. Задачи без конфликтов идут одновременно.
+	 *
+	 * Exclusive() — задача трогает всё (скрипты, удаление сущностей): всё, что объявлено
+	 * до неё, заканчивается раньше, всё после — начинается позже.
+	 * MainThread() — задача выполняется в потоке, вызвавшем Execute (OpenGL, ImGui).
+	 * Задача без ресурсов упорядочена только относительно Exclusive-задач.
+	 *
+	 * Порядок Add — порядок последовательного кадра: без рабочих потоков Execute
+	 * выполняет задачи ровно в нём.
+	 */
+	class TaskGraph
+	{
+	public:
+		using Resource = entt::id_type;
+
+		template <typename T>
+		static Resource ResourceOf() { return entt::type_hash<T>::value(); }
+
+		// Объявление доступа задачи: graph.Add("Physics", fn).Write<Transform>().Read<Sprite>()
+		class TaskBuilder
+		{
+		public:
+			template <typename... T>
+			TaskBuilder &Read()
+			{
+				(Read(ResourceOf<T>()), ...);
+				return *this;
+			}
+
+			template <typename... T>
+			TaskBuilder &Write()
+			{
+				(Write(ResourceOf<T>()), ...);
+				return *this;
+			}
+
+			TaskBuilder &Read(Resource resource);
+			TaskBuilder &Write(Resource resource);
+			TaskBuilder &Exclusive();
+			TaskBuilder &MainThread();
+
+		private:
+			friend class TaskGraph;
+			TaskBuilder(TaskGraph &graph, size_t task) : m_graph(graph), m_task(task) {}
+
+			TaskGraph &m_graph;
+			size_t m_task;
+		};
+
+		TaskGraph() = default;
+		TaskGraph(const TaskGraph &) = delete;
+		TaskGraph &operator=(const TaskGraph &) = delete;
+
+		TaskBuilder Add(std::string name, std::function<void()> function);
+		void Clear();
+
+		// Строит зависимости; Execute зовёт его сам, если задачи менялись
+		void Build();
+		// Выполняет все задачи и ждёт их. Поток-вызыватель выполняет задачи MainThread
+		// и помогает пулу с остальными.
+		void Execute(ThreadPool &pool = ThreadPool::Get());
+
+		size_t TaskCount() const { return m_tasks.size(); }
+		const std::string &GetTaskName(size_t task) const { return m_tasks[task].name; }
+		// Задачи, которые должны закончиться до task (после Build)
+		const std::vector<uint32_t> &GetDependencies(size_t task) const { return m_tasks[task].dependencies; }
+
+	private:
+		struct Task
+		{
+			std::string name;
+			std::function<void()> function;
+			std::vector<std::pair<Resource, bool>> access; // (ресурс, запись)
+			bool exclusive = false;
+			bool mainThread = false;
+
+			std::vector<uint32_t> dependencies;
+			std::vector<uint32_t> successors;
+			std::function<void(size_t)> runner; // function + уведомление графа — для ThreadPool::Batch
+			std::unique_ptr<ThreadPool::Batch> batch;
+		};
+
+		// Задача готова: в очередь пула или в очередь главного потока
+		void Schedule(uint32_t task);
+		void OnTaskDone(uint32_t task);
+		bool RunMainThreadTask();
+
+		std::vector<Task> m_tasks;
+		bool m_built = false;
+
+		// Состояние текущего Execute
+		ThreadPool *m_pool = nullptr;
+		std::unique_ptr<std::atomic<uint32_t>[]> m_remaining; // незавершённых зависимостей по задачам
+		std::atomic<size_t> m_completed{0};
+		std::mutex m_mainMutex;
+		std::vector<uint32_t> m_mainQueue;
+	};
+}
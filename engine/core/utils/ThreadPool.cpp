@@ -0,0 +1,219 @@
+#include <engine/core/utils/ThreadPool.hpp>
+
+namespace utils
+{
+	// Пул и номер очереди рабочего потока (у остальных потоков пула нет)
+	static thread_local const ThreadPool *t_pool = nullptr;
+	static thread_local size_t t_queueIndex = 0;
+
+	void ThreadPool::Batch::Reset(const std::function<void(size_t)> *task, size_t count)
+	{
+		m_task = task;
+		m_count = count;
+		m_next.store(0, std::memory_order_relaxed);
+		m_finished.store(0, std::memory_order_relaxed);
+		m_entries.store(0, std::memory_order_relaxed);
+	}
+
+	void ThreadPool::Batch::Execute()
+	{
+		for (;;)
+		{
+			size_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+			if (index >= m_count)
+				break;
+
+			(*m_task)(index);
+			m_finished.fetch_add(1, std::memory_order_release);
+		}
+	}
+
+	ThreadPool::ThreadPool(size_t threadCount)
+	{
+		if (threadCount == 0)
+		{
+			size_t hardware = std::thread::hardware_concurrency();
+			threadCount = hardware > 1 ? hardware : 1;
+		}
+
+		// Очереди рабочих + общая для остальных потоков — до запуска рабочих
+		for (size_t i = 0; i < threadCount; ++i)
+			m_queues.push_back(std::make_unique<Queue>());
+
+		// Вызывающий поток тоже выполняет задачи, поэтому рабочих на один меньше
+		for (size_t i = 1; i < threadCount; ++i)
+		{
+			m_workers.emplace_back([this, i]
+								   { WorkerLoop(i - 1); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_stop = true;
+		}
+		m_wakeCondition.notify_all();
+
+		for (auto &worker : m_workers)
+		{
+			worker.join();
+		}
+	}
+
+	ThreadPool &ThreadPool::Get()
+	{
+		static ThreadPool instance;
+		return instance;
+	}
+
+	void ThreadPool::Run(size_t taskCount, const std::function<void(size_t)> &task)
+	{
+		if (taskCount == 0)
+			return;
+
+		if (m_workers.empty() || taskCount == 1)
+		{
+			for (size_t i = 0; i < taskCount; ++i)
+				task(i);
+			return;
+		}
+
+		Batch batch;
+		batch.Reset(&task, taskCount);
+		Submit(batch, std::min(taskCount - 1, m_workers.size()));
+
+		batch.Execute();
+
+		// Пачка живёт на стеке: записи, которые никто не успел взять, забираем обратно.
+		// Остальные потоки уже выполняют взятые задачи — ждём только их, не подхватывая
+		// чужую работу (иначе в этот стек попала бы посторонняя задача).
+		Retract(batch);
+		while (!batch.IsFinished())
+			std::this_thread::yield();
+	}
+
+	void ThreadPool::Submit(Batch &batch, size_t helpers)
+	{
+		helpers = std::max<size_t>(helpers, 1);
+		batch.m_entries.fetch_add(helpers, std::memory_order_relaxed);
+
+		{
+			Queue &queue = *m_queues[LocalQueueIndex()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.items.insert(queue.items.end(), helpers, &batch);
+		}
+		m_pendingEntries.fetch_add(helpers, std::memory_order_release);
+
+		// Пустой захват под мьютексом сна — рабочий не пропустит пробуждение между
+		// проверкой m_pendingEntries и ожиданием
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+		if (helpers > 1)
+			m_wakeCondition.notify_all();
+		else
+			m_wakeCondition.notify_one();
+	}
+
+	bool ThreadPool::RunPendingTask()
+	{
+		Batch *batch = PopEntry();
+		if (batch == nullptr)
+			return false;
+
+		batch->Execute();
+		// После этого пачку может удалить её владелец — больше её не трогаем
+		batch->m_entries.fetch_sub(1, std::memory_order_acq_rel);
+		return true;
+	}
+
+	size_t ThreadPool::LocalQueueIndex() const
+	{
+		return t_pool == this ? t_queueIndex : m_queues.size() - 1;
+	}
+
+	ThreadPool::Batch *ThreadPool::PopEntry()
+	{
+		if (m_pendingEntries.load(std::memory_order_acquire) == 0)
+			return nullptr;
+
+		const size_t own = LocalQueueIndex();
+		const size_t queueCount = m_queues.size();
+
+		// Своя очередь — с конца: там последние, ещё горячие в кэше задачи
+		{
+			Queue &queue = *m_queues[own];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.items.empty())
+			{
+				Batch *batch = queue.items.back();
+				queue.items.pop_back();
+				m_pendingEntries.fetch_sub(1, std::memory_order_relaxed);
+				return batch;
+			}
+		}
+
+		// Чужие — с начала, начиная с соседа, чтобы воры не толпились у одной очереди
+		for (size_t k = 1; k < queueCount; ++k)
+		{
+			Queue &queue = *m_queues[(own + k) % queueCount];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.items.empty())
+			{
+				Batch *batch = queue.items.front();
+				queue.items.pop_front();
+				m_pendingEntries.fetch_sub(1, std::memory_order_relaxed);
+				return batch;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void ThreadPool::Retract(Batch &batch)
+	{
+		Queue &queue = *m_queues[LocalQueueIndex()];
+		size_t removed = 0;
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			for (auto it = queue.items.begin(); it != queue.items.end();)
+			{
+				if (*it == &batch)
+				{
+					it = queue.items.erase(it);
+					++removed;
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+
+		if (removed == 0)
+			return;
+
+		m_pendingEntries.fetch_sub(removed, std::memory_order_relaxed);
+		batch.m_entries.fetch_sub(removed, std::memory_order_acq_rel);
+	}
+
+	void ThreadPool::WorkerLoop(size_t index)
+	{
+		t_pool = this;
+		t_queueIndex = index;
+
+		for (;;)
+		{
+			if (RunPendingTask())
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wakeCondition.wait(lock, [this]
+								 { return m_stop || m_pendingEntries.load(std::memory_order_acquire) > 0; });
+			if (m_stop)
+				return;
+		}
+	}
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+	// ! Пул рабочих потоков с перехватом задач (work stealing): параллельные циклы физики,
+	// ! граф задач кадра (TaskGraph). У каждого рабочего своя очередь: свои записи он берёт
+	// ! с конца, свободные потоки забирают чужие с начала.
+	class ThreadPool
+	{
+	public:
+		/**
+		 * @brief Пачка задач task(0..count-1) для запуска без ожидания (Submit).
+		 *
+		 * Задачи разбирают по одной все потоки, взявшие запись пачки. Пачку нельзя
+		 * удалять или перезапускать, пока IsFinished() не вернёт true.
+		 */
+		class Batch
+		{
+		public:
+			Batch() = default;
+			Batch(const Batch &) = delete;
+			Batch &operator=(const Batch &) = delete;
+
+			void Reset(const std::function<void(size_t)> *task, size_t count);
+			// Все задачи выполнены, и пул к пачке больше не обращается
+			bool IsFinished() const
+			{
+				return m_finished.load(std::memory_order_acquire) == m_count &&
+					   m_entries.load(std::memory_order_acquire) == 0;
+			}
+
+		private:
+			friend class ThreadPool;
+
+			// Выполняет ещё не взятые задачи пачки
+			void Execute();
+
+			const std::function<void(size_t)> *m_task = nullptr;
+			size_t m_count = 0;
+			std::atomic<size_t> m_next{0};
+			std::atomic<size_t> m_finished{0};
+			std::atomic<size_t> m_entries{0}; // записей пачки в очередях и в работе
+		};
+
+		// threadCount = 0 — по числу ядер (вызывающий поток тоже работает)
+		explicit ThreadPool(size_t threadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool &) = delete;
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+		static ThreadPool &Get();
+
+		// Сколько потоков выполняет задачи, включая вызывающий
+		size_t WorkerCount() const { return m_workers.size() + 1; }
+
+		// Выполняет task(0..taskCount-1) на всех потоках и ждёт завершения.
+		// Вызывающий поток разбирает задачи вместе со всеми. Можно звать из задачи пула
+		// (вложенный цикл тоже идёт параллельно) и из нескольких потоков одновременно.
+		void Run(size_t taskCount, const std::function<void(size_t)> &task);
+
+		// Ставит пачку в очередь текущего потока и сразу возвращается.
+		// helpers — сколько потоков могут взяться за пачку одновременно.
+		void Submit(Batch &batch, size_t helpers = 1);
+		// Выполняет одну запись из очередей (своя, затем общая и чужие).
+		// false — работы нет. Для потоков, ждущих чего-то и готовых помочь.
+		bool RunPendingTask();
+
+		template <typename Func>
+		size_t ParallelFor(size_t count, size_t minChunk, Func &&fn)
+		{
+			size_t chunks = ChunkCount(count, minChunk);
+			if (chunks <= 1)
+			{
+				if (count > 0)
+					fn(size_t(0), count, size_t(0));
+				return count > 0 ? 1 : 0;
+			}
+
+			Run(chunks, [&](size_t chunk)
+				{
+				size_t begin = count * chunk / chunks;
+				size_t end = count * (chunk + 1) / chunks;
+				fn(begin, end, chunk); });
+
+			return chunks;
+		}
+
+		// Число кусков, на которые ParallelFor разобьёт count элементов
+		size_t ChunkCount(size_t count, size_t minChunk) const
+		{
+			if (count == 0)
+				return 0;
+
+			// Несколько кусков на поток — чтобы неравномерная работа балансировалась
+			size_t byCount = (count + std::max<size_t>(minChunk, 1) - 1) / std::max<size_t>(minChunk, 1);
+			return std::max<size_t>(1, std::min(byCount, WorkerCount() * 4));
+		}
+
+	private:
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<Batch *> items;
+		};
+
+		void WorkerLoop(size_t index);
+		// Очередь текущего потока: у рабочего своя, у остальных — общая (последняя)
+		size_t LocalQueueIndex() const;
+		Batch *PopEntry();
+		// Убирает из очереди текущего потока ещё не взятые записи пачки
+		void Retract(Batch &batch);
+
+		std::vector<std::thread> m_workers;
+		std::vector<std::unique_ptr<Queue>> m_queues;
+
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wakeCondition;
+		std::atomic<size_t> m_pendingEntries{0}; // записей во всех очередях
+		bool m_stop = false;
+	};
+}
@@ -2,6 +2,8 @@
 
 namespace utils
 {
+	// ! Время кадра окна (glfwGetTime). Фиксированные шаги симуляции считает
+	// ! utils::Clock своего мира (le::World::GetClock()).
 	class Time
 	{
 	public:
@@ -12,21 +12,21 @@ class CameraController : public ScriptComponent
 public:
 	void Update() override
 	{
-		float speed = 400.0f * utils::Time::DeltaTime();
+		float speed = 400.0f * DeltaTime();
 
-		if (InputManager::Get().IsKeyPressed(GLFW_KEY_UP))
+		if (Input().IsKeyPressed(GLFW_KEY_UP))
 		{
 			transform().position.y -= speed;
 		}
-		if (InputManager::Get().IsKeyPressed(GLFW_KEY_DOWN))
+		if (Input().IsKeyPressed(GLFW_KEY_DOWN))
 		{
 			transform().position.y += speed;
 		}
-		if (InputManager::Get().IsKeyPressed(GLFW_KEY_RIGHT))
+		if (Input().IsKeyPressed(GLFW_KEY_RIGHT))
 		{
 			transform().position.x += speed;
 		}
-		if (InputManager::Get().IsKeyPressed(GLFW_KEY_LEFT))
+		if (Input().IsKeyPressed(GLFW_KEY_LEFT))
 		{
 			transform().position.x -= speed;
 		}
@@ -33,13 +33,13 @@ public:
 		float moveSpeed = 200.0f; // Пикселей в секунду
 		glm::vec2 movement(0.0f, 0.0f);
 
-		if (InputManager::Get().IsKeyPressed(GLFW_KEY_W))
+		if (Input().IsKeyPressed(GLFW_KEY_W))
 			movement.y -= moveSpeed;
-		if (InputManager::Get().IsKeyPressed(GLFW_KEY_S))
+		if (Input().IsKeyPressed(GLFW_KEY_S))
 			movement.y += moveSpeed;
-		if (InputManager::Get().IsKeyPressed(GLFW_KEY_A))
+		if (Input().IsKeyPressed(GLFW_KEY_A))
 			movement.x -= moveSpeed;
-		if (InputManager::Get().IsKeyPressed(GLFW_KEY_D))
+		if (Input().IsKeyPressed(GLFW_KEY_D))
 			movement.x += moveSpeed;
 
 		float maxSpeed = 500.0f; // пикселей/сек
@@ -52,7 +52,7 @@ public:
 		rb.acceleration += movement * rb.GetMass(); // если используешь F = ma
 
 		// Управление активностью и уничтожением — без изменений
-		if (InputManager::Get().WasKeyPressed(GLFW_KEY_SPACE))
+		if (Input().WasKeyPressed(GLFW_KEY_SPACE))
 		{
 			if (targetEntity != entt::null && registry)
 			{
@@ -62,7 +62,7 @@ public:
 			}
 		}
 
-		if (InputManager::Get().WasKeyPressed(GLFW_KEY_F))
+		if (Input().WasKeyPressed(GLFW_KEY_F))
 		{
 			utils::Logger::info("Start destroy the Object!");
 			if (targetEntity != entt::null && registry)
@@ -0,0 +1,145 @@
+// tests/physics/IntegrationBatchTest.cpp
+// integrateBatch на каждом уровне SIMD должен совпадать бит в бит со старым
+// циклом по телам. Без OpenGL и реестра — только столбцы хранилища тел.
+#include <engine/core/physics/IntegrationBatch.hpp>
+#include <engine/core/physics/PhysicsBodyStore.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace le;
+
+namespace
+{
+	struct Columns
+	{
+		std::vector<glm::vec2> positions;
+		std::vector<glm::vec2> velocities;
+		std::vector<glm::vec2> accelerations;
+		std::vector<uint8_t> flags;
+		std::vector<uint8_t> changed;
+	};
+
+	constexpr uint8_t k_flagMask = PhysicsBodyStore::HasTransform | PhysicsBodyStore::Kinematic |
+								   PhysicsBodyStore::Static | PhysicsBodyStore::Sleeping;
+	constexpr uint8_t k_flagValue = PhysicsBodyStore::HasTransform;
+
+	// Не кратно 4 — работает и скалярный хвост
+	constexpr size_t k_bodyCount = 100003;
+	constexpr float k_dt = 1.0f / 60.0f;
+
+	Columns MakeBodies()
+	{
+		std::mt19937 rng(21);
+		std::uniform_real_distribution<float> value(-500.0f, 500.0f);
+		std::uniform_int_distribution<int> special(0, 15);
+		std::uniform_int_distribution<int> byte(0, 255);
+
+		// Иногда -0 или NaN вместо обычного числа
+		auto component = [&]
+		{
+			switch (special(rng))
+			{
+			case 0:
+				return -0.0f;
+			case 1:
+				return std::numeric_limits<float>::quiet_NaN();
+			default:
+				return value(rng);
+			}
+		};
+
+		Columns bodies;
+		bodies.positions.resize(k_bodyCount);
+		bodies.velocities.resize(k_bodyCount);
+		bodies.accelerations.resize(k_bodyCount);
+		bodies.flags.resize(k_bodyCount);
+		bodies.changed.resize(k_bodyCount);
+
+		for (size_t k = 0; k < k_bodyCount; ++k)
+		{
+			bodies.positions[k] = {component(), component()};
+			bodies.velocities[k] = {component(), component()};
+			bodies.accelerations[k] = {component(), component()};
+			// Все сочетания Kinematic/Static/Sleeping/HasTransform вперемешку с прочими битами
+			bodies.flags[k] = static_cast<uint8_t>(byte(rng));
+			bodies.changed[k] = static_cast<uint8_t>(byte(rng) & 1);
+		}
+
+		// И каждое из 16 сочетаний подряд — на границах векторов
+		const uint8_t bits[] = {PhysicsBodyStore::Kinematic, PhysicsBodyStore::Static,
+								PhysicsBodyStore::Sleeping, PhysicsBodyStore::HasTransform};
+		for (size_t combo = 0; combo < 16; ++combo)
+		{
+			uint8_t flags = 0;
+			for (size_t bit = 0; bit < 4; ++bit)
+			{
+				if (combo & (size_t(1) << bit))
+					flags |= bits[bit];
+			}
+			bodies.flags[combo] = flags;
+		}
+
+		return bodies;
+	}
+
+	// Старый цикл IntegratePositions: только бодрствующие динамические тела с Transform
+	void IntegrateReference(Columns &bodies)
+	{
+		for (size_t k = 0; k < k_bodyCount; ++k)
+		{
+			const uint8_t flags = bodies.flags[k];
+			if ((flags & PhysicsBodyStore::HasTransform) == 0 ||
+				(flags & (PhysicsBodyStore::Kinematic | PhysicsBodyStore::Static)) != 0 ||
+				(flags & PhysicsBodyStore::Sleeping) != 0)
+				continue;
+
+			bodies.velocities[k] += bodies.accelerations[k] * k_dt;
+			bodies.positions[k] += bodies.velocities[k] * k_dt;
+			bodies.accelerations[k] = glm::vec2(0.0f);
+			bodies.changed[k] = 1;
+		}
+	}
+
+	bool SameColumn(const std::vector<glm::vec2> &a, const std::vector<glm::vec2> &b)
+	{
+		return std::memcmp(a.data(), b.data(), a.size() * sizeof(glm::vec2)) == 0;
+	}
+
+	bool Check(const char *name, SimdLevel level, const Columns &initial, const Columns &reference)
+	{
+		Columns bodies = initial;
+		integrateBatch(bodies.positions.data(), bodies.velocities.data(), bodies.accelerations.data(),
+					   bodies.flags.data(), bodies.changed.data(), k_bodyCount, k_flagMask, k_flagValue, k_dt, level);
+
+		const bool positions = SameColumn(bodies.positions, reference.positions);
+		const bool velocities = SameColumn(bodies.velocities, reference.velocities);
+		const bool accelerations = SameColumn(bodies.accelerations, reference.accelerations);
+		const bool changed = std::memcmp(bodies.changed.data(), reference.changed.data(), k_bodyCount) == 0;
+
+		const bool ok = positions && velocities && accelerations && changed;
+		std::printf("%-6s %s (positions %d, velocities %d, accelerations %d, changed %d)\n",
+					name, ok ? "OK" : "FAILED", positions, velocities, accelerations, changed);
+		return ok;
+	}
+}
+
+int main()
+{
+	const Columns initial = MakeBodies();
+	Columns reference = initial;
+	IntegrateReference(reference);
+
+	bool ok = true;
+	ok &= Check("Scalar", SimdLevel::Scalar, initial, reference);
+	ok &= Check("SSE", SimdLevel::SSE, initial, reference);
+	if (BestSimdLevel() == SimdLevel::AVX2)
+		ok &= Check("AVX2", SimdLevel::AVX2, initial, reference);
+	else
+		std::printf("AVX2   skipped (not supported)\n");
+
+	return ok ? 0 : 1;
+}